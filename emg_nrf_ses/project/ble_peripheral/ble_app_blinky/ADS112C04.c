@@ -8,8 +8,8 @@ static const ads112c04_config_t raw_mode_config = {
     .mux_config = 0x08,   // AIN0 to AINP, AVSS to AINN
     .gain = 0x00,         // Gain = 1
     .pga_bypass = 0x00,   // PGA enabled
-    .data_rate = 0x06,    // 1000 SPS
-    .op_mode = 0x01,      // Turbo mode
+    .data_rate = 0x06,    // 1000 SPS (2000 SPS em turbo)
+    .op_mode = ADS112C04_RAW_OP_MODE, // Sinc do ADC como anti-aliasing na taxa do pipeline
     .conv_mode = 0x01,    // Continuous conversion
     .vref = 0x02,         // AVDD as reference
     .temp_sensor = 0x00,  // Temp sensor off
@@ -111,3 +111,31 @@ bool ads112c04_read_data(nrfx_twi_t *twi_instance, int16_t *raw_data) {
     
     return true;
 }
+
+// Troca a entrada do MUX mantendo ganho/PGA do modo raw e reinicia a conversão
+// com START/SYNC: o próximo DRDY já é a primeira conversão completa na entrada
+// nova (a que estava em curso durante a troca é descartada pelo ADC).
+bool ads112c04_select_input(nrfx_twi_t *twi_instance, uint8_t mux_config) {
+    const ads112c04_config_t *config = &raw_mode_config;
+    if (!ads112c04_write_reg(twi_instance, ADS112C04_CONFIG_0_REG,
+                             (mux_config << 4) |
+                             (config->gain << 1) |
+                             config->pga_bypass)) {
+        return false;
+    }
+    return ads112c04_start(twi_instance);
+}
+
+// Alterna entre a taxa do modo raw e a taxa de repouso (menor consumo do ADC).
+// A conversão contínua é reiniciada já na nova taxa.
+bool ads112c04_set_rest_mode(nrfx_twi_t *twi_instance, bool rest) {
+    const ads112c04_config_t *config = &raw_mode_config;
+    uint8_t data_rate = rest ? ADS112C04_REST_DATA_RATE : config->data_rate;
+    uint8_t op_mode   = rest ? ADS112C04_REST_OP_MODE : config->op_mode;
+    return ads112c04_write_reg(twi_instance, ADS112C04_CONFIG_1_REG,
+                               (data_rate << 5) |
+                               (op_mode << 4) |
+                               (config->conv_mode << 3) |
+                               (config->vref << 1) |
+                               config->temp_sensor);
+}
@@ -4,6 +4,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include "nrfx_twi.h"
+#include "emg_config.h"
 
 // Default I2C address
 #define ADS112C04_ADDRESS 0x40
@@ -21,6 +22,30 @@
 #define ADS112C04_CONFIG_2_REG      0x02
 #define ADS112C04_CONFIG_3_REG      0x03
 
+// MUX (CONFIG_0[7:4]): entrada single-ended AINx vs AVSS = 0x8 + x
+#define ADS112C04_MUX_AIN0_AVSS      0x08
+
+// Modo raw: DR=110 converte a 1000 SPS em modo normal (DRDY a cada conversão).
+// Variantes multi-site usam o turbo (2000 SPS): uma conversão por canal a 1 kHz.
+#if EMG_CHANNEL_COUNT > 1
+#define ADS112C04_RAW_OP_MODE        0x01
+#define ADS112C04_RAW_DATA_RATE_SPS  2000
+#else
+#define ADS112C04_RAW_OP_MODE        0x00
+#define ADS112C04_RAW_DATA_RATE_SPS  1000
+#endif
+
+// Orçamento de tempo no I2C (µs por transação, 9 bits por byte + start/stop)
+#define ADS112C04_TWI_FREQ_HZ        100000  // Deve seguir o .frequency de twi_init (main.c)
+#define ADS112C04_READ_BITS          49      // RDATA: [addr, cmd] + [addr, msb, lsb]
+#define ADS112C04_SELECT_BITS        49      // WREG [addr, cmd, cfg0] + START [addr, cmd]
+#define ADS112C04_BITS_US(bits)      (((bits) * 1000000UL) / ADS112C04_TWI_FREQ_HZ)
+
+// Modo de repouso (taxa adaptativa): modo normal, 330 SPS
+#define ADS112C04_REST_DATA_RATE     0x04
+#define ADS112C04_REST_OP_MODE       0x00
+#define ADS112C04_REST_DATA_RATE_SPS 330
+
 // Raw mode configuration
 typedef struct {
     uint8_t mux_config;
@@ -44,5 +69,7 @@ bool ads112c04_start(nrfx_twi_t *twi_instance);
 bool ads112c04_powerdown(nrfx_twi_t *twi_instance);
 bool ads112c04_configure_raw_mode(nrfx_twi_t *twi_instance);
 bool ads112c04_read_data(nrfx_twi_t *twi_instance, int16_t *raw_data);
+bool ads112c04_select_input(nrfx_twi_t *twi_instance, uint8_t mux_config);
+bool ads112c04_set_rest_mode(nrfx_twi_t *twi_instance, bool rest);
 
 #endif // ADS112C04_H
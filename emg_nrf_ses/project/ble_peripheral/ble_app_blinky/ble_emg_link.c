@@ -0,0 +1,311 @@
+#include "sdk_common.h"
+
+#include "ble_emg_link.h"
+#include "ble_conn_params.h"
+#include "ble_hci.h"
+#include "app_util.h"
+#include "app_error.h"
+#include "nrf_log.h"
+
+// Procedimentos do perfil ainda não aceitos pela SoftDevice
+#define LINK_PENDING_CONN_PARAMS      (1U << 0)
+#define LINK_PENDING_PHY              (1U << 1)
+#define LINK_PENDING_DATA_LENGTH      (1U << 2)
+#define LINK_PENDING_EVT_EXT          (1U << 3)
+
+#define LINK_DATA_LENGTH_MIN          27      // Payload LL padrão (Bluetooth 4.0)
+#define LINK_DATA_LENGTH_MAX          251     // DLE: MTU 247 + header L2CAP num pacote LL só
+
+#define LINK_SUP_TIMEOUT              MSEC_TO_UNITS(6000, UNIT_10_MS)
+
+// Supervision timeout > (1 + latency) * max_interval * 2 em todos os perfis
+static const ble_emg_link_cfg_t m_profiles[BLE_EMG_LINK_PROFILE_COUNT] = {
+    [BLE_EMG_LINK_IDLE] = {
+        "idle",
+        MSEC_TO_UNITS(200, UNIT_1_25_MS), MSEC_TO_UNITS(400, UNIT_1_25_MS), 4, LINK_SUP_TIMEOUT,
+        BLE_GAP_PHY_1MBPS, LINK_DATA_LENGTH_MIN, false
+    },
+    // Pacote de 60 amostras leva 60 ms para encher a 1 kSPS: um pacote por
+    // connection event, sem fragmentação com data length 251
+    [BLE_EMG_LINK_LOW_POWER] = {
+        "low-power",
+        MSEC_TO_UNITS(75, UNIT_1_25_MS), MSEC_TO_UNITS(100, UNIT_1_25_MS), 0, LINK_SUP_TIMEOUT,
+        BLE_GAP_PHY_1MBPS, LINK_DATA_LENGTH_MAX, true
+    },
+    [BLE_EMG_LINK_HIGH_THROUGHPUT] = {
+        "high-throughput",
+        MSEC_TO_UNITS(7.5, UNIT_1_25_MS), MSEC_TO_UNITS(15, UNIT_1_25_MS), 0, LINK_SUP_TIMEOUT,
+        BLE_GAP_PHY_2MBPS, LINK_DATA_LENGTH_MAX, true
+    },
+};
+
+static nrf_ble_gatt_t *       mp_gatt;
+static volatile uint16_t      m_conn_handle = BLE_CONN_HANDLE_INVALID;
+static volatile bool          m_conn_changed;    // Conexão abriu/fechou: estado refeito no contexto do rádio
+static ble_emg_link_profile_t m_profile   = BLE_EMG_LINK_INITIAL;  // Perfil aplicado
+static ble_emg_link_profile_t m_requested = BLE_EMG_LINK_INITIAL;  // Último pedido da demanda
+static uint8_t                m_forced    = BLE_EMG_LINK_AUTO;
+static uint8_t                m_hold_s;          // Segundos com demanda abaixo do perfil
+static uint8_t                m_pending;         // LINK_PENDING_*
+
+// Parâmetros negociados (escritos pelo observer)
+static volatile uint16_t      m_interval;
+static volatile uint16_t      m_latency;
+static volatile uint8_t       m_tx_phy;
+static volatile uint8_t       m_data_length;
+static volatile uint16_t      m_att_mtu;
+
+static ble_emg_link_profile_stats_t m_stats[BLE_EMG_LINK_PROFILE_COUNT];
+static uint32_t                     m_last_tx_bytes;
+
+// BUSY/INVALID_STATE = outro procedimento do link em andamento (ex.: PHY pedido
+// pelo central com o nosso em curso): fica pendente para o próximo tick. A
+// desconexão limpa os pendentes, então não repete para sempre
+static bool procedure_done(uint32_t err_code, char const * p_what)
+{
+    if (err_code == NRF_ERROR_BUSY || err_code == NRF_ERROR_INVALID_STATE) {
+        return false;
+    }
+    if (err_code != NRF_SUCCESS) {
+        NRF_LOG_WARNING("Link %s update failed: 0x%x", p_what, err_code);
+    }
+    return true;
+}
+
+static void apply_pending(void)
+{
+    uint16_t conn_handle = m_conn_handle;
+    ble_emg_link_cfg_t const * p_cfg = &m_profiles[m_profile];
+
+    if (m_pending & LINK_PENDING_EVT_EXT) {
+        // Opção global da SoftDevice, vale também fora de conexão
+        ble_opt_t opt;
+        memset(&opt, 0, sizeof(opt));
+        opt.common_opt.conn_evt_ext.enable = p_cfg->conn_evt_ext ? 1 : 0;
+        if (procedure_done(sd_ble_opt_set(BLE_COMMON_OPT_CONN_EVT_EXT, &opt), "event extension")) {
+            m_pending &= (uint8_t)~LINK_PENDING_EVT_EXT;
+        }
+    }
+
+    if (conn_handle == BLE_CONN_HANDLE_INVALID) {
+        m_pending &= LINK_PENDING_EVT_EXT;
+        return;
+    }
+
+    if (m_pending & LINK_PENDING_PHY) {
+        ble_gap_phys_t const phys = { .tx_phys = p_cfg->phy, .rx_phys = p_cfg->phy };
+        if (procedure_done(sd_ble_gap_phy_update(conn_handle, &phys), "PHY")) {
+            m_pending &= (uint8_t)~LINK_PENDING_PHY;
+        }
+    }
+
+    if (m_pending & LINK_PENDING_DATA_LENGTH) {
+        if (procedure_done(nrf_ble_gatt_data_length_set(mp_gatt, conn_handle, p_cfg->data_length),
+                           "data length")) {
+            m_pending &= (uint8_t)~LINK_PENDING_DATA_LENGTH;
+        }
+    }
+
+    if (m_pending & LINK_PENDING_CONN_PARAMS) {
+        // Pelo ble_conn_params: a faixa aceita na renegociação acompanha o perfil
+        ble_gap_conn_params_t conn_params = {
+            .min_conn_interval = p_cfg->min_interval,
+            .max_conn_interval = p_cfg->max_interval,
+            .slave_latency     = p_cfg->slave_latency,
+            .conn_sup_timeout  = p_cfg->sup_timeout,
+        };
+        if (procedure_done(ble_conn_params_change_conn_params(conn_handle, &conn_params), "connection parameters")) {
+            m_pending &= (uint8_t)~LINK_PENDING_CONN_PARAMS;
+        }
+    }
+}
+
+static void set_profile(ble_emg_link_profile_t profile)
+{
+    m_hold_s = 0;
+    if (profile == m_profile) {
+        return;
+    }
+    ble_emg_link_cfg_t const * p_old = &m_profiles[m_profile];
+    ble_emg_link_cfg_t const * p_new = &m_profiles[profile];
+
+    m_pending |= LINK_PENDING_CONN_PARAMS;
+    if (p_new->phy != p_old->phy) {
+        m_pending |= LINK_PENDING_PHY;
+    }
+    if (p_new->data_length != p_old->data_length) {
+        m_pending |= LINK_PENDING_DATA_LENGTH;
+    }
+    if (p_new->conn_evt_ext != p_old->conn_evt_ext) {
+        m_pending |= LINK_PENDING_EVT_EXT;
+    }
+    m_profile = profile;
+    NRF_LOG_INFO("Link profile: %s", p_new->p_name);
+    apply_pending();
+}
+
+// Conexão nova começa no perfil inicial (PPCP, data length padrão do nrf_ble_gatt)
+static void sync_connection(void)
+{
+    if (!m_conn_changed) {
+        return;
+    }
+    m_conn_changed = false;
+    if (m_profiles[m_profile].conn_evt_ext != m_profiles[BLE_EMG_LINK_INITIAL].conn_evt_ext) {
+        m_pending = LINK_PENDING_EVT_EXT;
+    } else {
+        m_pending = 0;
+    }
+    m_profile   = BLE_EMG_LINK_INITIAL;
+    m_requested = BLE_EMG_LINK_INITIAL;
+    m_forced    = BLE_EMG_LINK_AUTO;
+    m_hold_s    = 0;
+    apply_pending();
+}
+
+void ble_emg_link_init(nrf_ble_gatt_t * p_gatt)
+{
+    mp_gatt = p_gatt;
+    memset(m_stats, 0, sizeof(m_stats));
+    m_last_tx_bytes = 0;
+    m_att_mtu       = BLE_GATT_ATT_MTU_DEFAULT;
+
+    m_pending = LINK_PENDING_EVT_EXT;
+    apply_pending();
+}
+
+ble_emg_link_cfg_t const * ble_emg_link_cfg(ble_emg_link_profile_t profile)
+{
+    return &m_profiles[profile];
+}
+
+void ble_emg_link_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context)
+{
+    ble_gap_evt_t const * p_gap_evt = &p_ble_evt->evt.gap_evt;
+
+    switch (p_ble_evt->header.evt_id)
+    {
+        case BLE_GAP_EVT_CONNECTED:
+            m_interval     = p_gap_evt->params.connected.conn_params.max_conn_interval;
+            m_latency      = p_gap_evt->params.connected.conn_params.slave_latency;
+            m_tx_phy       = BLE_GAP_PHY_1MBPS;
+            m_data_length  = LINK_DATA_LENGTH_MIN;
+            m_att_mtu      = BLE_GATT_ATT_MTU_DEFAULT;
+            m_conn_handle  = p_gap_evt->conn_handle;
+            m_conn_changed = true;
+            break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            m_conn_handle  = BLE_CONN_HANDLE_INVALID;
+            m_interval     = 0;
+            m_conn_changed = true;
+            break;
+
+        case BLE_GAP_EVT_CONN_PARAM_UPDATE:
+            m_interval = p_gap_evt->params.conn_param_update.conn_params.max_conn_interval;
+            m_latency  = p_gap_evt->params.conn_param_update.conn_params.slave_latency;
+            NRF_LOG_INFO("Link interval %d x 1.25 ms, latency %d", m_interval, m_latency);
+            break;
+
+        case BLE_GAP_EVT_PHY_UPDATE_REQUEST:
+        {
+            // Central pediu troca de PHY: responde com o PHY do perfil atual.
+            // Com o nosso procedimento de PHY em curso a resposta volta BUSY:
+            // ele já conclui a troca; o pendente repete no tick se precisar
+            ble_gap_phys_t const phys = {
+                .tx_phys = m_profiles[m_profile].phy,
+                .rx_phys = m_profiles[m_profile].phy,
+            };
+            if (!procedure_done(sd_ble_gap_phy_update(p_gap_evt->conn_handle, &phys), "PHY reply")) {
+                m_pending |= LINK_PENDING_PHY;
+            }
+        } break;
+
+        case BLE_GAP_EVT_PHY_UPDATE:
+            if (p_gap_evt->params.phy_update.status == BLE_HCI_STATUS_CODE_SUCCESS) {
+                m_tx_phy = p_gap_evt->params.phy_update.tx_phy;
+                NRF_LOG_INFO("Link PHY: %s", (m_tx_phy == BLE_GAP_PHY_2MBPS) ? "2M" : "1M");
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+void ble_emg_link_on_gatt_evt(nrf_ble_gatt_evt_t const * p_evt)
+{
+    if (p_evt->evt_id == NRF_BLE_GATT_EVT_ATT_MTU_UPDATED) {
+        m_att_mtu = p_evt->params.att_mtu_effective;
+    } else if (p_evt->evt_id == NRF_BLE_GATT_EVT_DATA_LENGTH_UPDATED) {
+        m_data_length = p_evt->params.data_length;
+        NRF_LOG_INFO("Link data length: %d bytes", m_data_length);
+    }
+}
+
+void ble_emg_link_request(ble_emg_link_profile_t profile)
+{
+    sync_connection();
+    m_requested = profile;
+    if (m_forced != BLE_EMG_LINK_AUTO || m_conn_handle == BLE_CONN_HANDLE_INVALID) {
+        return;
+    }
+    if (profile > m_profile) {
+        set_profile(profile);
+    } else if (profile == m_profile) {
+        m_hold_s = 0;
+    }
+}
+
+bool ble_emg_link_force(uint8_t profile)
+{
+    sync_connection();
+    if (profile == BLE_EMG_LINK_AUTO) {
+        m_forced = BLE_EMG_LINK_AUTO;
+        m_hold_s = 0;
+        if (m_requested > m_profile) {
+            set_profile(m_requested);
+        }
+        NRF_LOG_INFO("Link profile: automatic");
+        return true;
+    }
+    if (profile >= BLE_EMG_LINK_PROFILE_COUNT) {
+        return false;
+    }
+    m_forced = profile;
+    set_profile((ble_emg_link_profile_t)profile);
+    return true;
+}
+
+void ble_emg_link_tick(uint32_t tx_bytes_total)
+{
+    sync_connection();
+
+    if (m_conn_handle != BLE_CONN_HANDLE_INVALID) {
+        m_stats[m_profile].time_s++;
+        m_stats[m_profile].tx_bytes += tx_bytes_total - m_last_tx_bytes;
+
+        if (m_forced == BLE_EMG_LINK_AUTO && m_requested < m_profile &&
+            ++m_hold_s >= BLE_EMG_LINK_HOLD_S) {
+            set_profile(m_requested);
+        }
+    }
+    m_last_tx_bytes = tx_bytes_total;
+
+    if (m_pending != 0) {
+        apply_pending();
+    }
+}
+
+void ble_emg_link_status(ble_emg_link_status_t * p_status)
+{
+    sync_connection();
+    p_status->profile       = (uint8_t)m_profile;
+    p_status->forced        = m_forced;
+    p_status->interval      = m_interval;
+    p_status->slave_latency = m_latency;
+    p_status->tx_phy        = m_tx_phy;
+    p_status->data_length   = m_data_length;
+    p_status->att_mtu       = m_att_mtu;
+    memcpy(p_status->profiles, m_stats, sizeof(m_stats));
+}
@@ -0,0 +1,82 @@
+#ifndef BLE_EMG_LINK_H__
+#define BLE_EMG_LINK_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ble.h"
+#include "nrf_ble_gatt.h"
+
+// Perfis do link BLE trocados em tempo de execução: intervalo de conexão,
+// slave latency, PHY, data length e extensão do connection event. O main.c
+// pede o perfil pela demanda dos streams inscritos; o client pode fixar um
+// perfil para medir vazão (bytes por perfil) e corrente (medida externa,
+// ex. PPK, com o perfil fixado).
+// Ordem crescente de demanda: subir de perfil é imediato, descer espera
+typedef enum {
+    BLE_EMG_LINK_IDLE = 0,            // Conectado sem stream: intervalo longo + latency
+    BLE_EMG_LINK_LOW_POWER,           // Stream filtrado: 75-100 ms, 1M
+    BLE_EMG_LINK_HIGH_THROUGHPUT,     // Bruto / catch-up do backlog: 7.5-15 ms, 2M
+    BLE_EMG_LINK_PROFILE_COUNT
+} ble_emg_link_profile_t;
+
+#define BLE_EMG_LINK_INITIAL          BLE_EMG_LINK_LOW_POWER  // PPCP e padrões do nrf_ble_gatt na conexão
+#define BLE_EMG_LINK_AUTO             0xFF    // Escrita do client: volta ao perfil pela demanda
+#define BLE_EMG_LINK_HOLD_S           5       // Segundos sem demanda antes de descer de perfil
+
+typedef struct {
+    char const * p_name;
+    uint16_t     min_interval;        // 1.25 ms
+    uint16_t     max_interval;        // 1.25 ms
+    uint16_t     slave_latency;
+    uint16_t     sup_timeout;         // 10 ms
+    uint8_t      phy;                 // BLE_GAP_PHY_*
+    uint8_t      data_length;         // Octetos de payload LL (27..251)
+    bool         conn_evt_ext;        // Estende o connection event enquanto houver dados
+} ble_emg_link_cfg_t;
+
+// Vazão medida por perfil (8 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint32_t time_s;                  // Tempo conectado no perfil
+    uint32_t tx_bytes;                // Bytes de notificação aceitos pelo SoftDevice no perfil
+} ble_emg_link_profile_stats_t;
+
+// Estado do link (34 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint8_t  profile;                 // ble_emg_link_profile_t aplicado
+    uint8_t  forced;                  // Perfil fixado pelo client ou BLE_EMG_LINK_AUTO
+    uint16_t interval;                // Intervalo negociado (1.25 ms, 0 = desconectado)
+    uint16_t slave_latency;           // Latency negociada
+    uint8_t  tx_phy;                  // BLE_GAP_PHY_* em uso
+    uint8_t  data_length;             // Payload LL negociado (TX)
+    uint16_t att_mtu;
+    ble_emg_link_profile_stats_t profiles[BLE_EMG_LINK_PROFILE_COUNT];
+} ble_emg_link_status_t;
+
+// p_gatt: instância do nrf_ble_gatt (data length por conexão)
+void ble_emg_link_init(nrf_ble_gatt_t * p_gatt);
+
+// Parâmetros do perfil (PPCP do GAP usa o perfil inicial)
+ble_emg_link_cfg_t const * ble_emg_link_cfg(ble_emg_link_profile_t profile);
+
+// Observer da SoftDevice: parâmetros negociados e resposta ao pedido de PHY do central
+void ble_emg_link_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context);
+
+// Repasse dos eventos do nrf_ble_gatt (MTU e data length negociados)
+void ble_emg_link_on_gatt_evt(nrf_ble_gatt_evt_t const * p_evt);
+
+// Perfil pedido pela demanda dos streams. Subir é imediato; descer espera
+// BLE_EMG_LINK_HOLD_S. Sem efeito com um perfil fixado pelo client.
+void ble_emg_link_request(ble_emg_link_profile_t profile);
+
+// Fixa um perfil (medição) ou volta ao automático (BLE_EMG_LINK_AUTO).
+// false = perfil inválido.
+bool ble_emg_link_force(uint8_t profile);
+
+// Tick de 1 s (contexto do rádio): tempo e bytes por perfil, descida pendente
+// e nova tentativa de procedimentos recusados (BUSY) pela SoftDevice.
+// tx_bytes_total: contador livre dos bytes enviados.
+void ble_emg_link_tick(uint32_t tx_bytes_total);
+
+void ble_emg_link_status(ble_emg_link_status_t * p_status);
+
+#endif // BLE_EMG_LINK_H__
@@ -2,25 +2,180 @@
 
 
 #include "ble_emg_service.h"
+#include "emg_config.h"
+#include "emg_bandpass.h"
 #include "ble_srv_common.h"
 #include "nrf_log.h"
+#include "app_util_platform.h"
 
+STATIC_ASSERT(EMG_PACKET_SIZE <= EMG_CODEC_MAX_SAMPLES && (EMG_PACKET_SIZE % 4) == 0);
+STATIC_ASSERT(sizeof(emg_stream_packet_t) == EMG_BACKLOG_RECORD_LEN);
+STATIC_ASSERT(sizeof(emg_packet_hdr_t) == 16);
+STATIC_ASSERT(EMG_MAX_PAYLOAD <= NRF_SDH_BLE_GATT_MAX_MTU_SIZE - 3);
+
+// CCCD das características com notificação: mantém o mapa de inscrições
+static void on_cccd_write(ble_emg_service_t * p_emg, ble_gatts_evt_write_t const * p_evt_write)
+{
+    const struct {
+        ble_gatts_char_handles_t const * p_handles;
+        uint16_t                         sub;
+    } cccds[] = {
+        { &p_emg->emg_char_handles,       EMG_SUB_STREAM    },
+        { &p_emg->fatigue_char_handles,   EMG_SUB_FATIGUE   },
+        { &p_emg->event_char_handles,     EMG_SUB_EVENT     },
+        { &p_emg->psd_char_handles,       EMG_SUB_PSD       },
+        { &p_emg->class_char_handles,     EMG_SUB_CLASS     },
+        { &p_emg->stats_char_handles,     EMG_SUB_STATS     },
+        { &p_emg->capture_char_handles,   EMG_SUB_CAPTURE   },
+        { &p_emg->raw_char_handles,       EMG_SUB_RAW       },
+        { &p_emg->trigger_char_handles,   EMG_SUB_TRIGGER   },
+        { &p_emg->evoked_char_handles,    EMG_SUB_EVOKED    },
+        { &p_emg->cross_char_handles,     EMG_SUB_CROSS     },
+        { &p_emg->rate_mode_char_handles, EMG_SUB_RATE_MODE },
+        { &p_emg->backlog_char_handles,   EMG_SUB_BACKLOG   },
+    };
+
+    if (p_evt_write->len != 2) {
+        return;
+    }
+    for (uint8_t i = 0; i < ARRAY_SIZE(cccds); i++) {
+        if (cccds[i].p_handles->cccd_handle != BLE_GATT_HANDLE_INVALID &&
+            p_evt_write->handle == cccds[i].p_handles->cccd_handle) {
+            if (ble_srv_is_notification_enabled(p_evt_write->data)) {
+                p_emg->subscriptions |= cccds[i].sub;
+            } else {
+                p_emg->subscriptions &= (uint16_t)~cccds[i].sub;
+            }
+            NRF_LOG_INFO("Subscriptions: 0x%04x", p_emg->subscriptions);
+            return;
+        }
+    }
+}
 
 static void on_write(ble_emg_service_t * p_emg, ble_evt_t const * p_ble_evt)
 {
     const ble_gatts_evt_write_t * p_evt_write = &p_ble_evt->evt.gatts_evt.params.write;
 
+    on_cccd_write(p_emg, p_evt_write);
+
     if (p_evt_write->handle == p_emg->gain_char_handles.value_handle && p_evt_write->len == 1) {
         uint8_t new_gain = p_evt_write->data[0];
 
         if (new_gain >= 1 && new_gain <= 10) {
             NRF_LOG_INFO("Gain write received: %d", new_gain);
-            // Aqui você salva o novo ganho ou chama um callback
-            // Exemplo: p_emg->gain_callback(new_gain); ou armazenar localmente
+            // Aplicado no DS3502 pelo handler de ganho do loop principal
+            p_emg->gain_level = new_gain;
         } else {
             NRF_LOG_WARNING("Invalid gain value received: %d (valid: 1-10)", new_gain);
         }
     }
+
+    if (p_evt_write->handle == p_emg->rate_char_handles.value_handle && p_evt_write->len == sizeof(uint16_t)) {
+        uint16_t new_rate = uint16_decode(p_evt_write->data);
+        NRF_LOG_INFO("Output rate write received: %d Hz", new_rate);
+        // Validado contra as taxas suportadas pelo decimador no loop principal
+        p_emg->output_rate_hz = new_rate;
+    }
+
+    if (p_evt_write->handle == p_emg->filter_char_handles.value_handle && p_evt_write->len == 1) {
+        NRF_LOG_INFO("Filter type write received: %d", p_evt_write->data[0]);
+        p_emg->filter_type = p_evt_write->data[0];
+    }
+
+    if (p_evt_write->handle == p_emg->psd_cfg_char_handles.value_handle && p_evt_write->len == 2) {
+        NRF_LOG_INFO("PSD config write received: 2^%d points, %d s",
+                     p_evt_write->data[0], p_evt_write->data[1]);
+        // Staging: o loop principal retira o par inteiro (take_psd_cfg)
+        CRITICAL_REGION_ENTER();
+        p_emg->psd_seconds     = p_evt_write->data[1];
+        p_emg->psd_seg_log2    = p_evt_write->data[0];
+        p_emg->psd_cfg_pending = true;
+        CRITICAL_REGION_EXIT();
+    }
+
+    if (p_evt_write->handle == p_emg->codec_char_handles.value_handle &&
+        p_evt_write->len == sizeof(emg_codec_cfg_t)) {
+        uint8_t  new_encoding  = p_evt_write->data[0];
+        uint16_t new_max_error = uint16_decode(&p_evt_write->data[1]);
+
+        if (new_encoding <= EMG_ENCODING_WAVELET) {
+            NRF_LOG_INFO("Codec write received: encoding %d, max error %d", new_encoding, new_max_error);
+            // Codec sem estado: vale a partir do próximo pacote
+            p_emg->max_error = new_max_error;
+            p_emg->encoding  = new_encoding;
+        } else {
+            NRF_LOG_WARNING("Invalid encoding received: %d", new_encoding);
+        }
+    }
+
+    if (p_evt_write->handle == p_emg->model_char_handles.value_handle && p_evt_write->len >= 2) {
+        uint16_t offset = uint16_decode(p_evt_write->data);
+
+        if (p_emg->model_commit_len != 0) {
+            // O loop principal ainda lê o staging: nada o altera até o status ser atualizado
+            NRF_LOG_WARNING("Model write ignored: activation pending");
+        } else if (offset == EMG_MODEL_COMMIT && p_evt_write->len == 4) {
+            // Validação e troca do modelo ficam no loop principal
+            p_emg->model_commit_len = uint16_decode(&p_evt_write->data[2]);
+            NRF_LOG_INFO("Model commit received: %d bytes", p_emg->model_commit_len);
+        } else if (!emg_classifier_stage(offset, &p_evt_write->data[2], p_evt_write->len - 2)) {
+            NRF_LOG_WARNING("Model chunk out of range: offset %d, %d bytes", offset, p_evt_write->len - 2);
+        }
+    }
+
+    if (p_evt_write->handle == p_emg->stats_char_handles.value_handle && p_evt_write->len == 1 &&
+        p_evt_write->data[0] == EMG_STATS_CMD_RESET) {
+        NRF_LOG_INFO("Stats reset received");
+        p_emg->stats_reset = true;
+    }
+
+    if (p_evt_write->handle == p_emg->capture_cfg_char_handles.value_handle) {
+        if (p_evt_write->len == 1 && p_evt_write->data[0] == EMG_CAPTURE_CMD_TRIGGER) {
+            p_emg->capture_client_trigger = true;
+            // O comando sobrescreveu o valor: restaura a configuração legível
+            (void)ble_emg_service_update_capture_cfg(p_emg);
+        } else if (p_evt_write->len == sizeof(emg_capture_cfg_t)) {
+            NRF_LOG_INFO("Capture config received: mode %d, triggers 0x%02x",
+                         p_evt_write->data[0], p_evt_write->data[1]);
+            // Janela validada no loop principal
+            p_emg->capture_pre_ms   = uint16_decode(&p_evt_write->data[2]);
+            p_emg->capture_post_ms  = uint16_decode(&p_evt_write->data[4]);
+            p_emg->capture_triggers = p_evt_write->data[1];
+            p_emg->capture_mode     = p_evt_write->data[0];
+        }
+    }
+
+    if (p_evt_write->handle == p_emg->evoked_cfg_char_handles.value_handle &&
+        p_evt_write->len == sizeof(emg_evoked_cfg_t)) {
+        NRF_LOG_INFO("Evoked config received: %d trials, %d ms",
+                     uint16_decode(p_evt_write->data), uint16_decode(&p_evt_write->data[2]));
+        // Validado no loop principal
+        p_emg->evoked_window_ms = uint16_decode(&p_evt_write->data[2]);
+        p_emg->evoked_trials    = uint16_decode(p_evt_write->data);
+    }
+
+    if (p_evt_write->handle == p_emg->rate_mode_char_handles.value_handle && p_evt_write->len == 1) {
+        NRF_LOG_INFO("Adaptive rate write received: %d", p_evt_write->data[0]);
+        p_emg->adaptive_rate = (p_evt_write->data[0] != 0);
+    }
+
+    if (p_evt_write->handle == p_emg->link_char_handles.value_handle && p_evt_write->len == 1) {
+        NRF_LOG_INFO("Link profile write received: %d", p_evt_write->data[0]);
+        // Validado no loop principal; o valor legível volta a ser o estado no próximo tick
+        p_emg->link_profile = p_evt_write->data[0];
+    }
+
+    if (p_evt_write->handle == p_emg->format_char_handles.value_handle && p_evt_write->len == 1) {
+        uint8_t new_version = p_evt_write->data[0];
+
+        if (new_version == EMG_PACKET_VERSION_1 || new_version == EMG_PACKET_VERSION_2) {
+            NRF_LOG_INFO("Packet format write received: v%d", new_version);
+            // Vale a partir do próximo pacote enviado
+            p_emg->packet_version = new_version;
+        } else {
+            NRF_LOG_WARNING("Invalid packet format received: %d", new_version);
+        }
+    }
 }
 
 void ble_emg_service_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context)
@@ -34,15 +189,24 @@ void ble_emg_service_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context)
             break;
 
         case BLE_GATTS_EVT_HVN_TX_COMPLETE:
-            // Notificação enviada com sucesso, libera para próxima transmissão
-            p_emg->tx_in_progress = false;
+        {
+            // Um evento pode confirmar várias notificações do mesmo connection event.
+            // As de baixa taxa também entram na contagem: o contador satura em zero
+            uint8_t count = p_ble_evt->evt.gatts_evt.params.hvn_tx_complete.count;
+            p_emg->tx_in_flight = (count >= p_emg->tx_in_flight) ? 0 : (uint8_t)(p_emg->tx_in_flight - count);
 
-            // Log periódico de TX complete (a cada 100 eventos = ~1 segundo)
-            static uint32_t tx_complete_count = 0;
-            if (tx_complete_count % 100 == 0) {
-                NRF_LOG_INFO("BLE TX complete: %d notifications sent", tx_complete_count);
+            // Log periódico de TX complete (a cada ~100 notificações)
+            uint32_t before = p_emg->tx_complete_count;
+            p_emg->tx_complete_count += count;
+            if (before / 100 != p_emg->tx_complete_count / 100) {
+                NRF_LOG_INFO("BLE TX complete: %d notifications sent", p_emg->tx_complete_count);
             }
-            tx_complete_count++;
+        } break;
+
+        case BLE_GAP_EVT_DISCONNECTED:
+            // Fila do SoftDevice descartada com a conexão; sem bonding os CCCDs voltam a zero
+            p_emg->tx_in_flight  = 0;
+            p_emg->subscriptions = 0;
             break;
 
         default:
@@ -75,8 +239,9 @@ uint32_t ble_emg_service_init(ble_emg_service_t * p_emg)
     memset(&add_char_params, 0, sizeof(add_char_params));
     add_char_params.uuid              = EMG_CHAR_UUID;
     add_char_params.uuid_type         = p_emg->uuid_type;
-    add_char_params.max_len           = EMG_MAX_PAYLOAD;  // 40 bytes para pacotes
+    add_char_params.max_len           = EMG_MAX_PAYLOAD;  // v2 comprimido; v1 RAW = 60 amostras
     add_char_params.init_len          = sizeof(uint16_t);
+    add_char_params.is_var_len        = true;             // Pacotes comprimidos são menores
     add_char_params.char_props.notify = 1;
     add_char_params.cccd_write_access = SEC_OPEN;
 
@@ -84,8 +249,11 @@ uint32_t ble_emg_service_init(ble_emg_service_t * p_emg)
     VERIFY_SUCCESS(err_code);
     NRF_LOG_INFO("EMG notify characteristic added - max payload: %d bytes", EMG_MAX_PAYLOAD);
 
-    // Inicializa flag de controle
-    p_emg->tx_in_progress = false;
+    // Inicializa controle de fluxo e ganho padrão
+    p_emg->gain_level        = 10;
+    p_emg->tx_in_flight      = 0;
+    p_emg->tx_complete_count = 0;
+    p_emg->tx_bytes          = 0;
 
     // --- Add Gain Characteristic (write) ---
     memset(&add_char_params, 0, sizeof(add_char_params));
@@ -100,6 +268,425 @@ uint32_t ble_emg_service_init(ble_emg_service_t * p_emg)
     VERIFY_SUCCESS(err_code);
     NRF_LOG_INFO("Gain write characteristic added");
 
+    // --- Add Fatigue Characteristic (notify, baixa taxa) ---
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_FATIGUE_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(emg_fatigue_metrics_t);
+    add_char_params.init_len          = sizeof(emg_fatigue_metrics_t);
+    add_char_params.char_props.notify = 1;
+    add_char_params.cccd_write_access = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->fatigue_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Fatigue notify characteristic added - %d bytes", sizeof(emg_fatigue_metrics_t));
+
+    // --- Add Activation Event Characteristic (notify) ---
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_EVENT_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(emg_activation_evt_t);
+    add_char_params.init_len          = sizeof(emg_activation_evt_t);
+    add_char_params.char_props.notify = 1;
+    add_char_params.cccd_write_access = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->event_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Activation event characteristic added");
+
+    // --- Add Output Rate Characteristic (read/write, uint16 Hz) ---
+    p_emg->output_rate_hz = EMG_SAMPLE_RATE_HZ;
+
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_RATE_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(uint16_t);
+    add_char_params.init_len          = sizeof(uint16_t);
+    add_char_params.p_init_value      = (uint8_t *)&p_emg->output_rate_hz;
+    add_char_params.char_props.read   = 1;
+    add_char_params.char_props.write  = 1;
+    add_char_params.read_access       = SEC_OPEN;
+    add_char_params.write_access      = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->rate_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Output rate characteristic added");
+
+    // --- Add Filter Type Characteristic (read/write, 0 = IIR, 1 = FIR) ---
+    p_emg->filter_type = EMG_BANDPASS_DEFAULT;
+
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_FILTER_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(uint8_t);
+    add_char_params.init_len          = sizeof(uint8_t);
+    add_char_params.p_init_value      = (uint8_t *)&p_emg->filter_type;
+    add_char_params.char_props.read   = 1;
+    add_char_params.char_props.write  = 1;
+    add_char_params.read_access       = SEC_OPEN;
+    add_char_params.write_access      = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->filter_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Filter type characteristic added");
+
+    // --- Add PSD Characteristic (read/notify, tamanho variável) ---
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_PSD_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(emg_welch_snapshot_t);
+    add_char_params.init_len          = EMG_WELCH_HEADER_LEN;
+    add_char_params.is_var_len        = true;
+    add_char_params.char_props.read   = 1;
+    add_char_params.char_props.notify = 1;
+    add_char_params.read_access       = SEC_OPEN;
+    add_char_params.cccd_write_access = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->psd_char_handles);
+    VERIFY_SUCCESS(err_code);
+
+    // --- Add PSD Config Characteristic (read/write: uint8 log2 pontos, uint8 segundos) ---
+    uint8_t psd_cfg[2] = { EMG_WELCH_DEFAULT_LOG2, EMG_WELCH_DEFAULT_SECONDS };
+    p_emg->psd_seg_log2    = psd_cfg[0];
+    p_emg->psd_seconds     = psd_cfg[1];
+    p_emg->psd_cfg_pending = false;
+
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_PSD_CFG_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(psd_cfg);
+    add_char_params.init_len          = sizeof(psd_cfg);
+    add_char_params.p_init_value      = psd_cfg;
+    add_char_params.char_props.read   = 1;
+    add_char_params.char_props.write  = 1;
+    add_char_params.read_access       = SEC_OPEN;
+    add_char_params.write_access      = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->psd_cfg_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("PSD characteristics added - max %d bytes", sizeof(emg_welch_snapshot_t));
+
+    // --- Add Codec Characteristic (read/write: emg_codec_cfg_t) ---
+    emg_codec_cfg_t codec_cfg = { EMG_ENCODING_RAW, 0 };
+    p_emg->encoding  = codec_cfg.encoding;
+    p_emg->max_error = codec_cfg.max_error;
+
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_CODEC_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(codec_cfg);
+    add_char_params.init_len          = sizeof(codec_cfg);
+    add_char_params.p_init_value      = (uint8_t *)&codec_cfg;
+    add_char_params.char_props.read   = 1;
+    add_char_params.char_props.write  = 1;
+    add_char_params.read_access       = SEC_OPEN;
+    add_char_params.write_access      = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->codec_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Codec characteristic added");
+
+    // --- Add Class Characteristic (read/notify, 1 byte) ---
+    uint8_t class_init = EMG_CLF_CLASS_NONE;
+
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_CLASS_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(uint8_t);
+    add_char_params.init_len          = sizeof(uint8_t);
+    add_char_params.p_init_value      = &class_init;
+    add_char_params.char_props.read   = 1;
+    add_char_params.char_props.notify = 1;
+    add_char_params.read_access       = SEC_OPEN;
+    add_char_params.cccd_write_access = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->class_char_handles);
+    VERIFY_SUCCESS(err_code);
+
+    // --- Add Model Characteristic (write: chunks do blob, read: emg_classifier_status_t) ---
+    emg_classifier_status_t clf_status;
+    emg_classifier_status(&clf_status);
+    p_emg->model_commit_len = 0;
+
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_MODEL_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = EMG_MODEL_WRITE_MAX;
+    add_char_params.init_len          = sizeof(clf_status);
+    add_char_params.p_init_value      = (uint8_t *)&clf_status;
+    add_char_params.is_var_len        = true;
+    add_char_params.char_props.read   = 1;
+    add_char_params.char_props.write  = 1;
+    add_char_params.read_access       = SEC_OPEN;
+    add_char_params.write_access      = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->model_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Classifier characteristics added");
+
+    // --- Add Session Stats Characteristic (read/notify: snapshot, write: reset) ---
+    emg_stats_snapshot_t stats_init;
+    memset(&stats_init, 0, sizeof(stats_init));
+    p_emg->stats_reset = false;
+
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_STATS_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(emg_stats_snapshot_t);
+    add_char_params.init_len          = sizeof(emg_stats_snapshot_t);
+    add_char_params.p_init_value      = (uint8_t *)&stats_init;
+    add_char_params.is_var_len        = true;             // Comando de reset tem 1 byte
+    add_char_params.char_props.read   = 1;
+    add_char_params.char_props.write  = 1;
+    add_char_params.char_props.notify = 1;
+    add_char_params.read_access       = SEC_OPEN;
+    add_char_params.write_access      = SEC_OPEN;
+    add_char_params.cccd_write_access = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->stats_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Session stats characteristic added");
+
+    // --- Add Capture Characteristic (notify, chunks de burst) ---
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_CAPTURE_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(emg_capture_chunk_t);
+    add_char_params.init_len          = EMG_CAPTURE_HEADER_LEN;
+    add_char_params.is_var_len        = true;
+    add_char_params.char_props.notify = 1;
+    add_char_params.cccd_write_access = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->capture_char_handles);
+    VERIFY_SUCCESS(err_code);
+
+    // --- Add Capture Config Characteristic (read/write: emg_capture_cfg_t ou comando) ---
+    emg_capture_cfg_t capture_cfg = { EMG_CAPTURE_MODE_STREAM, EMG_CAPTURE_SRC_ONSET,
+                                      EMG_CAPTURE_DEFAULT_PRE_MS, EMG_CAPTURE_DEFAULT_POST_MS };
+    p_emg->capture_mode           = capture_cfg.mode;
+    p_emg->capture_triggers       = capture_cfg.trigger_mask;
+    p_emg->capture_pre_ms         = capture_cfg.pre_ms;
+    p_emg->capture_post_ms        = capture_cfg.post_ms;
+    p_emg->capture_client_trigger = false;
+
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_CAPTURE_CFG_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(capture_cfg);
+    add_char_params.init_len          = sizeof(capture_cfg);
+    add_char_params.p_init_value      = (uint8_t *)&capture_cfg;
+    add_char_params.is_var_len        = true;             // Comando de trigger tem 1 byte
+    add_char_params.char_props.read   = 1;
+    add_char_params.char_props.write  = 1;
+    add_char_params.read_access       = SEC_OPEN;
+    add_char_params.write_access      = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->capture_cfg_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Capture characteristics added - chunk max %d bytes", sizeof(emg_capture_chunk_t));
+
+    // --- Add Pipeline Characteristic (read: ciclos por estágio no último segundo) ---
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_PIPELINE_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = EMG_PIPELINE_MAX_STAGES * sizeof(emg_stage_stats_t);
+    add_char_params.init_len          = 0;
+    add_char_params.is_var_len        = true;
+    add_char_params.char_props.read   = 1;
+    add_char_params.read_access       = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->pipeline_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Pipeline stats characteristic added");
+
+    // --- Add Raw EMG Characteristic (notify, amostras do ADC sem filtro) ---
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_RAW_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = EMG_PACKET_V2_RAW_LEN;
+    add_char_params.init_len          = sizeof(uint16_t);
+    add_char_params.is_var_len        = true;             // v1 e v2 têm tamanhos diferentes
+    add_char_params.char_props.notify = 1;
+    add_char_params.cccd_write_access = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->raw_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Raw EMG characteristic added");
+
+    // --- Add Trigger Characteristic (notify, trigger externo marcado no stream) ---
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_TRIGGER_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(emg_trigger_evt_t);
+    add_char_params.init_len          = sizeof(emg_trigger_evt_t);
+    add_char_params.char_props.notify = 1;
+    add_char_params.cccd_write_access = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->trigger_char_handles);
+    VERIFY_SUCCESS(err_code);
+
+    // --- Add Evoked Config Characteristic (read/write: emg_evoked_cfg_t) ---
+    emg_evoked_cfg_t evoked_cfg = { 0, EMG_EVOKED_DEFAULT_WINDOW_MS };
+    p_emg->evoked_trials    = evoked_cfg.trials;
+    p_emg->evoked_window_ms = evoked_cfg.window_ms;
+
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_EVOKED_CFG_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(evoked_cfg);
+    add_char_params.init_len          = sizeof(evoked_cfg);
+    add_char_params.p_init_value      = (uint8_t *)&evoked_cfg;
+    add_char_params.char_props.read   = 1;
+    add_char_params.char_props.write  = 1;
+    add_char_params.read_access       = SEC_OPEN;
+    add_char_params.write_access      = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->evoked_cfg_char_handles);
+    VERIFY_SUCCESS(err_code);
+
+    // --- Add Evoked Characteristic (notify, chunks da média) ---
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_EVOKED_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(emg_evoked_chunk_t);
+    add_char_params.init_len          = EMG_EVOKED_HEADER_LEN;
+    add_char_params.is_var_len        = true;
+    add_char_params.char_props.notify = 1;
+    add_char_params.cccd_write_access = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->evoked_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Trigger/evoked characteristics added - chunk max %d bytes", sizeof(emg_evoked_chunk_t));
+
+#if EMG_CHANNEL_COUNT > 1
+    // --- Add Cross-Channel Characteristic (notify, métricas por par de canais) ---
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_CROSS_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(emg_cross_snapshot_t);
+    add_char_params.init_len          = EMG_CROSS_HEADER_LEN;
+    add_char_params.is_var_len        = true;
+    add_char_params.char_props.notify = 1;
+    add_char_params.cccd_write_access = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->cross_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Cross-channel characteristic added - %d channels", EMG_CHANNEL_COUNT);
+#endif
+
+    // --- Add Rate Mode Characteristic (read/write/notify: taxa adaptativa) ---
+    emg_rate_evt_t rate_init = { 0, EMG_ADAPT_FULL, EMG_SAMPLE_RATE_HZ, 0, 0 };
+    p_emg->adaptive_rate = false;
+
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_RATE_MODE_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(emg_rate_evt_t);
+    add_char_params.init_len          = sizeof(emg_rate_evt_t);
+    add_char_params.p_init_value      = (uint8_t *)&rate_init;
+    add_char_params.is_var_len        = true;             // Escrita tem 1 byte
+    add_char_params.char_props.read   = 1;
+    add_char_params.char_props.write  = 1;
+    add_char_params.char_props.notify = 1;
+    add_char_params.read_access       = SEC_OPEN;
+    add_char_params.write_access      = SEC_OPEN;
+    add_char_params.cccd_write_access = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->rate_mode_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Rate mode characteristic added");
+
+    // --- Add Store Characteristic (read: ocupação e perdas do sample store) ---
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_STORE_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(emg_store_stats_t);
+    add_char_params.init_len          = 0;
+    add_char_params.is_var_len        = true;
+    add_char_params.char_props.read   = 1;
+    add_char_params.read_access       = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->store_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Store stats characteristic added - %d frames", EMG_STORE_FRAMES);
+
+    // --- Add Backlog Characteristic (notify, pacotes atrasados com sequência) ---
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_BACKLOG_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = MAX(sizeof(emg_backlog_v1_t), EMG_PACKET_V2_RAW_LEN);
+    add_char_params.init_len          = sizeof(uint32_t);
+    add_char_params.is_var_len        = true;
+    add_char_params.char_props.notify = 1;
+    add_char_params.cccd_write_access = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->backlog_char_handles);
+    VERIFY_SUCCESS(err_code);
+
+    // --- Add Backlog Stats Characteristic (read) ---
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_BACKLOG_STATS_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(emg_backlog_stats_t);
+    add_char_params.init_len          = 0;
+    add_char_params.is_var_len        = true;
+    add_char_params.char_props.read   = 1;
+    add_char_params.read_access       = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->backlog_stats_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Backlog characteristics added - %d packets", EMG_BACKLOG_PACKETS);
+
+    // --- Add Scheduler Characteristic (read: prazos por tipo de evento no último segundo) ---
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_SCHED_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = EMG_SCHED_MAX_EVENTS * sizeof(emg_sched_stats_t);
+    add_char_params.init_len          = 0;
+    add_char_params.is_var_len        = true;
+    add_char_params.char_props.read   = 1;
+    add_char_params.read_access       = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->sched_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Scheduler stats characteristic added");
+
+    // --- Add Link Profile Characteristic (read: ble_emg_link_status_t, write: perfil fixado) ---
+    p_emg->link_profile = BLE_EMG_LINK_AUTO;
+
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_LINK_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(ble_emg_link_status_t);
+    add_char_params.init_len          = 0;
+    add_char_params.is_var_len        = true;             // Escrita tem 1 byte
+    add_char_params.char_props.read   = 1;
+    add_char_params.char_props.write  = 1;
+    add_char_params.read_access       = SEC_OPEN;
+    add_char_params.write_access      = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->link_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Link profile characteristic added");
+
+    // --- Add Packet Format Characteristic (read/write, EMG_PACKET_VERSION_*) ---
+    p_emg->packet_version = EMG_PACKET_VERSION_1;
+
+    memset(&add_char_params, 0, sizeof(add_char_params));
+    add_char_params.uuid              = EMG_FORMAT_CHAR_UUID;
+    add_char_params.uuid_type         = p_emg->uuid_type;
+    add_char_params.max_len           = sizeof(uint8_t);
+    add_char_params.init_len          = sizeof(uint8_t);
+    add_char_params.p_init_value      = (uint8_t *)&p_emg->packet_version;
+    add_char_params.char_props.read   = 1;
+    add_char_params.char_props.write  = 1;
+    add_char_params.read_access       = SEC_OPEN;
+    add_char_params.write_access      = SEC_OPEN;
+
+    err_code = characteristic_add(p_emg->service_handle, &add_char_params, &p_emg->format_char_handles);
+    VERIFY_SUCCESS(err_code);
+    NRF_LOG_INFO("Packet format characteristic added");
+
     NRF_LOG_INFO("EMG service initialization complete");
     return NRF_SUCCESS;
 }
@@ -121,9 +708,17 @@ uint32_t ble_emg_service_notify(ble_emg_service_t * p_emg, uint16_t conn_handle,
     return sd_ble_gatts_hvx(conn_handle, &params);
 }
 
-// Nova função para enviar pacotes de múltiplas amostras
-uint32_t ble_emg_service_notify_packet(ble_emg_service_t * p_emg, uint16_t conn_handle,
-                                        int16_t * p_data, uint16_t num_samples)
+// Inscrição rastreada nas escritas de CCCD: sem chamada à SoftDevice por pacote
+static bool notify_enabled(ble_emg_service_t const * p_emg, uint16_t sub)
+{
+    return (p_emg->subscriptions & sub) != 0;
+}
+
+// Envio de streams de amostras com controle de fluxo compartilhado (tx_in_flight):
+// até EMG_HVN_TX_QUEUE_SIZE notificações na fila do SoftDevice
+static uint32_t notify_stream(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                              ble_gatts_char_handles_t const * p_handles, uint16_t sub,
+                              void const * p_data, uint16_t len)
 {
     if (conn_handle == BLE_CONN_HANDLE_INVALID) {
         NRF_LOG_WARNING("Notify packet failed: invalid connection handle");
@@ -131,22 +726,12 @@ uint32_t ble_emg_service_notify_packet(ble_emg_service_t * p_emg, uint16_t conn_
     }
 
     // CRITICAL FIX: Check if CCCD is enabled before sending notifications
-    uint16_t cccd_value = 0;
-    ble_gatts_value_t gatts_value;
-    memset(&gatts_value, 0, sizeof(gatts_value));
-    gatts_value.len = sizeof(cccd_value);
-    gatts_value.p_value = (uint8_t*)&cccd_value;
-
-    uint32_t cccd_err = sd_ble_gatts_value_get(conn_handle,
-                                                 p_emg->emg_char_handles.cccd_handle,
-                                                 &gatts_value);
-
-    if (cccd_err != NRF_SUCCESS || cccd_value != BLE_GATT_HVX_NOTIFICATION) {
+    if (!notify_enabled(p_emg, sub)) {
         // CCCD not enabled - silently return (client hasn't subscribed yet)
         return NRF_ERROR_INVALID_STATE;
     }
 
-    if (p_emg->tx_in_progress) {
+    if (p_emg->tx_in_flight >= EMG_HVN_TX_QUEUE_SIZE) {
         // Log apenas em caso de busy recorrente (debug)
         static uint32_t busy_count = 0;
         if (busy_count++ % 100 == 0) {
@@ -155,31 +740,29 @@ uint32_t ble_emg_service_notify_packet(ble_emg_service_t * p_emg, uint16_t conn_
         return NRF_ERROR_BUSY;
     }
 
-    if (num_samples == 0 || p_data == NULL) {
+    if (p_data == NULL || len == 0) {
         NRF_LOG_ERROR("Notify packet failed: invalid parameters");
         return NRF_ERROR_INVALID_PARAM;
     }
 
     ble_gatts_hvx_params_t params;
-    uint16_t len = num_samples * sizeof(int16_t);
-
-    // Limita ao tamanho máximo permitido
-    if (len > EMG_MAX_PAYLOAD) {
-        len = EMG_MAX_PAYLOAD;
-        NRF_LOG_WARNING("Packet size limited to %d bytes", EMG_MAX_PAYLOAD);
-    }
 
     memset(&params, 0, sizeof(params));
     params.type   = BLE_GATT_HVX_NOTIFICATION;
-    params.handle = p_emg->emg_char_handles.value_handle;
-    params.p_data = (uint8_t*)p_data;
+    params.handle = p_handles->value_handle;
+    params.p_data = (uint8_t const *)p_data;
     params.p_len  = &len;
 
-    p_emg->tx_in_progress = true;
     uint32_t err_code = sd_ble_gatts_hvx(conn_handle, &params);
 
-    if (err_code != NRF_SUCCESS) {
-        p_emg->tx_in_progress = false;
+    if (err_code == NRF_SUCCESS) {
+        // O HVN_TX_COMPLETE decrementa em outro contexto (IRQ ou tarefa da SoftDevice)
+        CRITICAL_REGION_ENTER();
+        p_emg->tx_in_flight++;
+        p_emg->tx_bytes += len;
+        CRITICAL_REGION_EXIT();
+    } else if (err_code != NRF_ERROR_RESOURCES) {
+        // RESOURCES = fila do SoftDevice cheia (notificações de baixa taxa ocupam slots)
         static uint32_t err_count = 0;
         if (err_count++ % 10 == 0) {
             NRF_LOG_ERROR("Notify packet failed: err=0x%x, count=%d", err_code, err_count);
@@ -189,4 +772,346 @@ uint32_t ble_emg_service_notify_packet(ble_emg_service_t * p_emg, uint16_t conn_
     return err_code;
 }
 
+// Nova função para enviar pacotes de múltiplas amostras
+uint32_t ble_emg_service_notify_packet(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                        emg_packet_t const * p_packet)
+{
+    return notify_stream(p_emg, conn_handle, &p_emg->emg_char_handles, EMG_SUB_STREAM,
+                         p_packet->samples, EMG_PACKET_V1_LEN);
+}
+
+uint32_t ble_emg_service_notify_raw(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                     emg_packet_t const * p_packet)
+{
+    return notify_stream(p_emg, conn_handle, &p_emg->raw_char_handles, EMG_SUB_RAW,
+                         p_packet->samples, EMG_PACKET_V1_LEN);
+}
+
+uint32_t ble_emg_service_notify_encoded(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                         emg_codec_packet_t const * p_packet, uint16_t len)
+{
+    return notify_stream(p_emg, conn_handle, &p_emg->emg_char_handles, EMG_SUB_STREAM, p_packet, len);
+}
+
+uint32_t ble_emg_service_notify_packet_v2(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                           emg_packet_hdr_t const * p_hdr, uint16_t len)
+{
+    return notify_stream(p_emg, conn_handle, &p_emg->emg_char_handles, EMG_SUB_STREAM, p_hdr, len);
+}
+
+uint32_t ble_emg_service_notify_raw_v2(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                        emg_packet_hdr_t const * p_hdr, uint16_t len)
+{
+    return notify_stream(p_emg, conn_handle, &p_emg->raw_char_handles, EMG_SUB_RAW, p_hdr, len);
+}
+
+uint32_t ble_emg_service_notify_backlog(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                         emg_stream_packet_t const * p_packet)
+{
+    if (p_emg->packet_version == EMG_PACKET_VERSION_2) {
+        return notify_stream(p_emg, conn_handle, &p_emg->backlog_char_handles, EMG_SUB_BACKLOG,
+                             &p_packet->hdr, EMG_PACKET_V2_RAW_LEN);
+    }
+
+    // v1: a sequência vai na frente do pacote (o SoftDevice copia o payload)
+    emg_backlog_v1_t record;
+    record.seq    = p_packet->hdr.seq;
+    record.packet = p_packet->packet;
+    return notify_stream(p_emg, conn_handle, &p_emg->backlog_char_handles, EMG_SUB_BACKLOG,
+                         &record, sizeof(record));
+}
+
+// Notificação simples para características de baixa taxa (eventos, métricas)
+static uint32_t notify_value(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                             ble_gatts_char_handles_t const * p_handles, uint16_t sub,
+                             void const * p_data, uint16_t len)
+{
+    if (conn_handle == BLE_CONN_HANDLE_INVALID) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    if (!notify_enabled(p_emg, sub)) {
+        return NRF_ERROR_INVALID_STATE;
+    }
+
+    ble_gatts_hvx_params_t params;
+
+    memset(&params, 0, sizeof(params));
+    params.type   = BLE_GATT_HVX_NOTIFICATION;
+    params.handle = p_handles->value_handle;
+    params.p_data = (uint8_t const *)p_data;
+    params.p_len  = &len;
+
+    // Poucas notificações por segundo: não disputam tx_in_flight com o stream EMG
+    uint32_t err_code = sd_ble_gatts_hvx(conn_handle, &params);
+    if (err_code == NRF_SUCCESS) {
+        // Chamado das tarefas DSP e rádio na variante FreeRTOS
+        CRITICAL_REGION_ENTER();
+        p_emg->tx_bytes += len;
+        CRITICAL_REGION_EXIT();
+    }
+    return err_code;
+}
+
+uint32_t ble_emg_service_notify_fatigue(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                         emg_fatigue_metrics_t const * p_metrics)
+{
+    return notify_value(p_emg, conn_handle, &p_emg->fatigue_char_handles, EMG_SUB_FATIGUE,
+                        p_metrics, sizeof(emg_fatigue_metrics_t));
+}
+
+uint32_t ble_emg_service_notify_activation(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                            emg_activation_evt_t const * p_evt)
+{
+    return notify_value(p_emg, conn_handle, &p_emg->event_char_handles, EMG_SUB_EVENT,
+                        p_evt, sizeof(emg_activation_evt_t));
+}
+
+uint32_t ble_emg_service_update_rate(ble_emg_service_t * p_emg)
+{
+    uint16_t rate_hz = p_emg->output_rate_hz;
+
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = sizeof(rate_hz);
+    gatts_value.p_value = (uint8_t *)&rate_hz;
+
+    return sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                  p_emg->rate_char_handles.value_handle,
+                                  &gatts_value);
+}
+
+bool ble_emg_service_take_psd_cfg(ble_emg_service_t * p_emg, uint8_t * p_seg_log2, uint8_t * p_seconds)
+{
+    bool pending;
+
+    CRITICAL_REGION_ENTER();
+    pending = p_emg->psd_cfg_pending;
+    if (pending) {
+        *p_seg_log2            = p_emg->psd_seg_log2;
+        *p_seconds             = p_emg->psd_seconds;
+        p_emg->psd_cfg_pending = false;
+    }
+    CRITICAL_REGION_EXIT();
+    return pending;
+}
+
+uint32_t ble_emg_service_update_psd_cfg(ble_emg_service_t * p_emg, uint8_t seg_log2, uint8_t seconds)
+{
+    uint8_t cfg[2] = { seg_log2, seconds };
+
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = sizeof(cfg);
+    gatts_value.p_value = cfg;
+
+    return sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                  p_emg->psd_cfg_char_handles.value_handle,
+                                  &gatts_value);
+}
+
+uint32_t ble_emg_service_update_psd(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                     emg_welch_snapshot_t const * p_snap, uint16_t len)
+{
+    // Mantém o valor legível atualizado mesmo sem inscrição (leitura sob demanda)
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = len;
+    gatts_value.p_value = (uint8_t *)p_snap;
+
+    uint32_t err_code = sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                               p_emg->psd_char_handles.value_handle,
+                                               &gatts_value);
+    VERIFY_SUCCESS(err_code);
+
+    return notify_value(p_emg, conn_handle, &p_emg->psd_char_handles, EMG_SUB_PSD, p_snap, len);
+}
+
+uint32_t ble_emg_service_notify_class(ble_emg_service_t * p_emg, uint16_t conn_handle, uint8_t class_id)
+{
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = sizeof(class_id);
+    gatts_value.p_value = &class_id;
+
+    uint32_t err_code = sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                               p_emg->class_char_handles.value_handle,
+                                               &gatts_value);
+    VERIFY_SUCCESS(err_code);
+
+    return notify_value(p_emg, conn_handle, &p_emg->class_char_handles, EMG_SUB_CLASS,
+                        &class_id, sizeof(class_id));
+}
+
+uint32_t ble_emg_service_update_classifier_status(ble_emg_service_t * p_emg,
+                                                   emg_classifier_status_t const * p_status)
+{
+    // O valor da característica é sobrescrito pelos chunks escritos; a leitura
+    // seguinte ao commit já devolve o estado atualizado
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = sizeof(emg_classifier_status_t);
+    gatts_value.p_value = (uint8_t *)p_status;
+
+    return sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                  p_emg->model_char_handles.value_handle,
+                                  &gatts_value);
+}
+
+uint32_t ble_emg_service_update_stats(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                       emg_stats_snapshot_t const * p_snap)
+{
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = sizeof(emg_stats_snapshot_t);
+    gatts_value.p_value = (uint8_t *)p_snap;
+
+    uint32_t err_code = sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                               p_emg->stats_char_handles.value_handle,
+                                               &gatts_value);
+    VERIFY_SUCCESS(err_code);
+
+    return notify_value(p_emg, conn_handle, &p_emg->stats_char_handles, EMG_SUB_STATS,
+                        p_snap, sizeof(emg_stats_snapshot_t));
+}
+
+uint32_t ble_emg_service_notify_capture(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                         emg_capture_chunk_t const * p_chunk, uint16_t len)
+{
+    return notify_value(p_emg, conn_handle, &p_emg->capture_char_handles, EMG_SUB_CAPTURE,
+                        p_chunk, len);
+}
+
+uint32_t ble_emg_service_update_capture_cfg(ble_emg_service_t * p_emg)
+{
+    emg_capture_cfg_t cfg = { p_emg->capture_mode, p_emg->capture_triggers,
+                              p_emg->capture_pre_ms, p_emg->capture_post_ms };
+
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = sizeof(cfg);
+    gatts_value.p_value = (uint8_t *)&cfg;
+
+    return sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                  p_emg->capture_cfg_char_handles.value_handle,
+                                  &gatts_value);
+}
+
+uint32_t ble_emg_service_notify_trigger(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                         emg_trigger_evt_t const * p_evt)
+{
+    return notify_value(p_emg, conn_handle, &p_emg->trigger_char_handles, EMG_SUB_TRIGGER,
+                        p_evt, sizeof(emg_trigger_evt_t));
+}
+
+uint32_t ble_emg_service_notify_evoked(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                        emg_evoked_chunk_t const * p_chunk, uint16_t len)
+{
+    return notify_value(p_emg, conn_handle, &p_emg->evoked_char_handles, EMG_SUB_EVOKED,
+                        p_chunk, len);
+}
 
+uint32_t ble_emg_service_update_evoked_cfg(ble_emg_service_t * p_emg)
+{
+    emg_evoked_cfg_t cfg = { p_emg->evoked_trials, p_emg->evoked_window_ms };
+
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = sizeof(cfg);
+    gatts_value.p_value = (uint8_t *)&cfg;
+
+    return sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                  p_emg->evoked_cfg_char_handles.value_handle,
+                                  &gatts_value);
+}
+
+uint32_t ble_emg_service_notify_cross(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                       emg_cross_snapshot_t const * p_snap, uint16_t len)
+{
+    return notify_value(p_emg, conn_handle, &p_emg->cross_char_handles, EMG_SUB_CROSS, p_snap, len);
+}
+
+uint32_t ble_emg_service_notify_rate_mode(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                           emg_rate_evt_t const * p_evt)
+{
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = sizeof(emg_rate_evt_t);
+    gatts_value.p_value = (uint8_t *)p_evt;
+
+    uint32_t err_code = sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                               p_emg->rate_mode_char_handles.value_handle,
+                                               &gatts_value);
+    VERIFY_SUCCESS(err_code);
+
+    return notify_value(p_emg, conn_handle, &p_emg->rate_mode_char_handles, EMG_SUB_RATE_MODE,
+                        p_evt, sizeof(emg_rate_evt_t));
+}
+
+uint32_t ble_emg_service_update_pipeline_stats(ble_emg_service_t * p_emg,
+                                                emg_stage_stats_t const * p_stats, uint8_t n)
+{
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = (uint16_t)(n * sizeof(emg_stage_stats_t));
+    gatts_value.p_value = (uint8_t *)p_stats;
+
+    return sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                  p_emg->pipeline_char_handles.value_handle,
+                                  &gatts_value);
+}
+
+uint32_t ble_emg_service_update_store_stats(ble_emg_service_t * p_emg, emg_store_stats_t const * p_stats)
+{
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = sizeof(emg_store_stats_t);
+    gatts_value.p_value = (uint8_t *)p_stats;
+
+    return sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                  p_emg->store_char_handles.value_handle,
+                                  &gatts_value);
+}
+
+uint32_t ble_emg_service_update_backlog_stats(ble_emg_service_t * p_emg,
+                                               emg_backlog_stats_t const * p_stats)
+{
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = sizeof(emg_backlog_stats_t);
+    gatts_value.p_value = (uint8_t *)p_stats;
+
+    return sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                  p_emg->backlog_stats_char_handles.value_handle,
+                                  &gatts_value);
+}
+
+uint32_t ble_emg_service_update_sched_stats(ble_emg_service_t * p_emg,
+                                             emg_sched_stats_t const * p_stats, uint8_t n)
+{
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = (uint16_t)(n * sizeof(emg_sched_stats_t));
+    gatts_value.p_value = (uint8_t *)p_stats;
+
+    return sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                  p_emg->sched_char_handles.value_handle,
+                                  &gatts_value);
+}
+
+uint32_t ble_emg_service_update_link_status(ble_emg_service_t * p_emg, ble_emg_link_status_t const * p_status)
+{
+    ble_gatts_value_t gatts_value;
+    memset(&gatts_value, 0, sizeof(gatts_value));
+    gatts_value.len     = sizeof(ble_emg_link_status_t);
+    gatts_value.p_value = (uint8_t *)p_status;
+
+    return sd_ble_gatts_value_set(BLE_CONN_HANDLE_INVALID,
+                                  p_emg->link_char_handles.value_handle,
+                                  &gatts_value);
+}
+
+bool ble_emg_service_is_subscribed(ble_emg_service_t const * p_emg, uint16_t sub)
+{
+    return p_emg->conn_handle != BLE_CONN_HANDLE_INVALID && notify_enabled(p_emg, sub);
+}
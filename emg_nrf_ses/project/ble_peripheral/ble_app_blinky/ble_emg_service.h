@@ -4,6 +4,21 @@
 #include <stdint.h>
 #include "ble.h"
 #include "ble_srv_common.h"
+#include "emg_spectral.h"
+#include "emg_activation.h"
+#include "emg_welch.h"
+#include "emg_codec.h"
+#include "emg_classifier.h"
+#include "emg_stats.h"
+#include "emg_capture.h"
+#include "emg_pipeline.h"
+#include "emg_evoked.h"
+#include "emg_cross.h"
+#include "emg_adaptive.h"
+#include "emg_store.h"
+#include "emg_backlog.h"
+#include "emg_sched.h"
+#include "ble_emg_link.h"
 
 #define EMG_SERVICE_UUID_BASE         { 0x14, 0xA1, 0x68, 0xD1, 0x6C, 0x4F, 0x7E, 0x53, \
                                         0xF2, 0xE8, 0x00, 0x10, 0x00, 0x00, 0xB1, 0x19 }
@@ -11,6 +26,31 @@
 #define EMG_SERVICE_UUID              0x0001
 #define EMG_CHAR_UUID                 0x0002
 #define EMG_GAIN_CHAR_UUID            0x0003
+#define EMG_FATIGUE_CHAR_UUID         0x0004
+#define EMG_EVENT_CHAR_UUID           0x0005
+#define EMG_RATE_CHAR_UUID            0x0006
+#define EMG_FILTER_CHAR_UUID          0x0007
+#define EMG_PSD_CHAR_UUID             0x0008
+#define EMG_PSD_CFG_CHAR_UUID         0x0009
+#define EMG_CODEC_CHAR_UUID           0x000A
+#define EMG_CLASS_CHAR_UUID           0x000B
+#define EMG_MODEL_CHAR_UUID           0x000C
+#define EMG_STATS_CHAR_UUID           0x000D
+#define EMG_CAPTURE_CHAR_UUID         0x000E
+#define EMG_CAPTURE_CFG_CHAR_UUID     0x000F
+#define EMG_PIPELINE_CHAR_UUID        0x0010
+#define EMG_RAW_CHAR_UUID             0x0011
+#define EMG_TRIGGER_CHAR_UUID         0x0012
+#define EMG_EVOKED_CFG_CHAR_UUID      0x0013
+#define EMG_EVOKED_CHAR_UUID          0x0014
+#define EMG_CROSS_CHAR_UUID           0x0015  // Só nas variantes multi-site (EMG_CHANNEL_COUNT > 1)
+#define EMG_RATE_MODE_CHAR_UUID       0x0016
+#define EMG_STORE_CHAR_UUID           0x0017
+#define EMG_BACKLOG_CHAR_UUID         0x0018
+#define EMG_BACKLOG_STATS_CHAR_UUID   0x0019
+#define EMG_SCHED_CHAR_UUID           0x001A
+#define EMG_LINK_CHAR_UUID            0x001B
+#define EMG_FORMAT_CHAR_UUID          0x001C
 
 // Configuração de pacotes otimizados para MTU 247 (alta performance)
 // MTU 247 = 244 bytes úteis (247 - 3 bytes header)
@@ -19,15 +59,166 @@
 //   - 15ms @ 2kHz = 30 amostras → 2 buffers de 60 amostras = 30ms latência
 //   - Throughput: ~133 pacotes/s x 60 amostras = 7980 Hz capacity (4x headroom)
 #define EMG_PACKET_SIZE               60      // Número de amostras por pacote
-#define EMG_MAX_PAYLOAD               (EMG_PACKET_SIZE * sizeof(int16_t))  // 120 bytes
+
+// Pacote EMG: amostras seguidas das flags de qualidade do bloco
+// (EMG_QUALITY_FLAG_* em emg_quality.h). As amostras ficam no offset 0: o
+// payload legado (v1) é só o trecho das amostras, sem as flags.
+typedef struct __attribute__((packed)) {
+    int16_t  samples[EMG_PACKET_SIZE];
+    uint16_t quality_flags;
+} emg_packet_t;
+
+#define EMG_PACKET_V1_LEN             (EMG_PACKET_SIZE * sizeof(int16_t))  // 120 bytes, formato original
+
+// Formato do payload das características EMG Data e Raw EMG, escolhido pelo
+// client. v1 (padrão) mantém os apps existentes: emg_packet_t ou
+// emg_codec_packet_t sem header. v2 prefixa emg_packet_hdr_t.
+#define EMG_PACKET_VERSION_1          1
+#define EMG_PACKET_VERSION_2          2
+
+// Header do payload v2 (16 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint8_t  version;             // EMG_PACKET_VERSION_2
+    uint8_t  encoding;            // emg_encoding_t: RAW = int16[sample_count], WAVELET = emg_codec_packet_t
+    uint8_t  sample_count;        // Amostras no pacote
+    uint8_t  gain_epoch;          // Trocas de ganho aplicadas até a primeira amostra (mod 256)
+    uint32_t seq;                 // Sequência do pacote no stream (a mesma dos registros do backlog)
+    uint32_t first_sample;        // Índice da primeira amostra na taxa de aquisição (base dos eventos)
+    uint16_t rate_hz;             // Taxa das amostras do pacote
+    uint16_t quality_flags;       // EMG_QUALITY_FLAG_*
+} emg_packet_hdr_t;
+
+// Buffer de stream: o header v2 fica logo antes do pacote v1, então os dois
+// formatos saem do mesmo buffer sem cópia (v1 a partir de packet, v2 a partir
+// de hdr até o fim das amostras; as flags do v1 vão no header)
+typedef struct __attribute__((packed)) {
+    emg_packet_hdr_t hdr;
+    emg_packet_t     packet;
+} emg_stream_packet_t;
+
+#define EMG_PACKET_V2_RAW_LEN         (sizeof(emg_packet_hdr_t) + EMG_PACKET_SIZE * sizeof(int16_t))  // 136 bytes
+
+// Pacote do backlog no formato v1: sequência + pacote com flags (126 bytes).
+// No v2 o backlog sai como o stream RAW (header + amostras).
+typedef struct __attribute__((packed)) {
+    uint32_t     seq;
+    emg_packet_t packet;
+} emg_backlog_v1_t;
+
+// Pacote v2 comprimido: header seguido do pacote do codec
+typedef struct __attribute__((packed)) {
+    emg_packet_hdr_t   hdr;
+    emg_codec_packet_t codec;
+} emg_stream_codec_t;
+
+// Inscrições do client (CCCD com notificação), rastreadas nas escritas de CCCD.
+// Um bit por característica com notify; o gerenciador de streams do main.c
+// liga aquisição, estágios e empacotamento conforme o mapa.
+#define EMG_SUB_STREAM                (1U << 0)
+#define EMG_SUB_FATIGUE               (1U << 1)
+#define EMG_SUB_EVENT                 (1U << 2)
+#define EMG_SUB_PSD                   (1U << 3)
+#define EMG_SUB_CLASS                 (1U << 4)
+#define EMG_SUB_STATS                 (1U << 5)
+#define EMG_SUB_CAPTURE               (1U << 6)
+#define EMG_SUB_RAW                   (1U << 7)
+#define EMG_SUB_TRIGGER               (1U << 8)
+#define EMG_SUB_EVOKED                (1U << 9)
+#define EMG_SUB_CROSS                 (1U << 10)
+#define EMG_SUB_RATE_MODE             (1U << 11)
+#define EMG_SUB_BACKLOG               (1U << 12)
+#define EMG_SUB_ALL                   ((1U << 13) - 1)
+
+// Fila de notificações do SoftDevice por conexão (ble_gatts_conn_cfg_t):
+// até N notificações de stream em voo, várias saem no mesmo connection event
+#define EMG_HVN_TX_QUEUE_SIZE         8
+
+// Escrita do modelo do classificador: uint16 offset + trecho do blob.
+// offset = EMG_MODEL_COMMIT com uint16 tamanho total ativa o modelo em staging.
+#define EMG_MODEL_COMMIT              0xFFFF
+#define EMG_MODEL_WRITE_MAX           (NRF_SDH_BLE_GATT_MAX_MTU_SIZE - 3)
+
+// A característica EMG transporta int16[60] (EMG_ENCODING_RAW, 120 bytes) ou
+// emg_codec_packet_t de tamanho variável quando o client ativa a compressão,
+// com emg_packet_hdr_t na frente no formato v2
+#define EMG_MAX_PAYLOAD               sizeof(emg_stream_codec_t)  // 142 bytes (v2 comprimido)
+
+// Configuração do codec (3 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint8_t  encoding;            // emg_encoding_t
+    uint16_t max_error;           // Erro absoluto máximo por amostra, em contagens do ADC
+} emg_codec_cfg_t;
+
+// Configuração da captura por evento (6 bytes, little-endian).
+// Escrita de 1 byte EMG_CAPTURE_CMD_TRIGGER dispara uma captura pelo client.
+typedef struct __attribute__((packed)) {
+    uint8_t  mode;                // emg_capture_mode_t
+    uint8_t  trigger_mask;        // EMG_CAPTURE_SRC_* habilitadas
+    uint16_t pre_ms;
+    uint16_t post_ms;
+} emg_capture_cfg_t;
+
+// Configuração da média evocada (4 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint16_t trials;              // Épocas por média (0 = desligada)
+    uint16_t window_ms;           // Janela pós-trigger
+} emg_evoked_cfg_t;
 
 typedef struct {
     uint16_t                    service_handle;
     ble_gatts_char_handles_t    emg_char_handles;
     ble_gatts_char_handles_t    gain_char_handles;
+    ble_gatts_char_handles_t    fatigue_char_handles;
+    ble_gatts_char_handles_t    event_char_handles;
+    ble_gatts_char_handles_t    rate_char_handles;
+    ble_gatts_char_handles_t    filter_char_handles;
+    ble_gatts_char_handles_t    psd_char_handles;
+    ble_gatts_char_handles_t    psd_cfg_char_handles;
+    ble_gatts_char_handles_t    codec_char_handles;
+    ble_gatts_char_handles_t    class_char_handles;
+    ble_gatts_char_handles_t    model_char_handles;
+    ble_gatts_char_handles_t    stats_char_handles;
+    ble_gatts_char_handles_t    capture_char_handles;
+    ble_gatts_char_handles_t    capture_cfg_char_handles;
+    ble_gatts_char_handles_t    pipeline_char_handles;
+    ble_gatts_char_handles_t    raw_char_handles;
+    ble_gatts_char_handles_t    trigger_char_handles;
+    ble_gatts_char_handles_t    evoked_cfg_char_handles;
+    ble_gatts_char_handles_t    evoked_char_handles;
+    ble_gatts_char_handles_t    cross_char_handles;
+    ble_gatts_char_handles_t    rate_mode_char_handles;
+    ble_gatts_char_handles_t    store_char_handles;
+    ble_gatts_char_handles_t    backlog_char_handles;
+    ble_gatts_char_handles_t    backlog_stats_char_handles;
+    ble_gatts_char_handles_t    sched_char_handles;
+    ble_gatts_char_handles_t    link_char_handles;
+    ble_gatts_char_handles_t    format_char_handles;
     uint8_t                     uuid_type;
     uint16_t                    conn_handle;
-    bool                        tx_in_progress;  // Flag de controle de transmissão
+    uint8_t                     tx_in_flight;    // Notificações de stream aceitas e não confirmadas
+    volatile uint16_t           subscriptions;   // EMG_SUB_* com notificação habilitada
+    uint32_t                    tx_complete_count; // Total confirmado (soma de hvn_tx_complete.count)
+    uint32_t                    tx_bytes;        // Bytes de notificação aceitos pelo SoftDevice (vazão por perfil do link)
+    volatile uint8_t            gain_level;      // Ganho pedido pelo client (1..10, aplicado no handler de ganho)
+    volatile uint16_t           output_rate_hz;  // Taxa pedida pelo client (aplicada no loop principal)
+    volatile uint8_t            filter_type;     // emg_bandpass_type_t pedido pelo client
+    uint8_t                     psd_seg_log2;    // Resolução do Welch pedida (staging, ver take_psd_cfg)
+    uint8_t                     psd_seconds;     // Janela do Welch pedida (staging)
+    volatile bool               psd_cfg_pending; // Par novo escrito pelo client
+    volatile uint8_t            encoding;        // emg_encoding_t do stream EMG
+    volatile uint16_t           max_error;       // Limite de erro do codec wavelet
+    volatile uint16_t           model_commit_len; // Blob em staging a ativar (0 = nada pendente; != 0 trava o staging)
+    volatile bool               stats_reset;     // Client pediu nova sessão de estatísticas
+    volatile uint8_t            capture_mode;    // emg_capture_mode_t
+    volatile uint8_t            capture_triggers; // EMG_CAPTURE_SRC_* habilitadas
+    volatile uint16_t           capture_pre_ms;
+    volatile uint16_t           capture_post_ms;
+    volatile bool               capture_client_trigger;
+    volatile uint16_t           evoked_trials;
+    volatile uint16_t           evoked_window_ms;
+    volatile bool               adaptive_rate;   // Client ligou a taxa adaptativa
+    volatile uint8_t            link_profile;    // Perfil do link fixado pelo client (BLE_EMG_LINK_AUTO = pela demanda)
+    volatile uint8_t            packet_version;  // EMG_PACKET_VERSION_* dos streams EMG Data e Raw
 } ble_emg_service_t;
 
 void ble_emg_service_on_ble_evt(ble_evt_t const * p_ble_evt, void * p_context);
@@ -37,8 +228,112 @@ uint32_t ble_emg_service_init(ble_emg_service_t * p_emg);
 // Função original - mantida para compatibilidade
 uint32_t ble_emg_service_notify(ble_emg_service_t * p_emg, uint16_t conn_handle, uint16_t emg_value);
 
-// Nova função para enviar pacotes de múltiplas amostras (otimizado)
+// Nova função para enviar pacotes de múltiplas amostras (otimizado). Só as
+// amostras (EMG_PACKET_V1_LEN): as flags de qualidade seguem no formato v2
 uint32_t ble_emg_service_notify_packet(ble_emg_service_t * p_emg, uint16_t conn_handle,
-                                        int16_t * p_data, uint16_t num_samples);
+                                        emg_packet_t const * p_packet);
+
+// Pacote de amostras brutas do ADC (taxa de aquisição) pela característica de stream bruto:
+// só as amostras (EMG_PACKET_V1_LEN, formato original); flags de qualidade só no v2
+uint32_t ble_emg_service_notify_raw(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                     emg_packet_t const * p_packet);
+
+// Envia um pacote comprimido (len = retorno de emg_codec_encode) pela característica EMG
+uint32_t ble_emg_service_notify_encoded(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                         emg_codec_packet_t const * p_packet, uint16_t len);
+
+// Pacote v2 pela característica EMG: header seguido do payload, len bytes ao todo
+uint32_t ble_emg_service_notify_packet_v2(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                           emg_packet_hdr_t const * p_hdr, uint16_t len);
+
+// Pacote v2 pela característica de stream bruto
+uint32_t ble_emg_service_notify_raw_v2(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                        emg_packet_hdr_t const * p_hdr, uint16_t len);
+
+// Notificação de baixa taxa com MNF/MDF/potência por janela espectral
+uint32_t ble_emg_service_notify_fatigue(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                         emg_fatigue_metrics_t const * p_metrics);
+
+// Evento de onset/offset de ativação com timestamp em amostras
+uint32_t ble_emg_service_notify_activation(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                            emg_activation_evt_t const * p_evt);
+
+// Reescreve o valor legível da taxa de saída (taxa recusada volta à aceita)
+uint32_t ble_emg_service_update_rate(ble_emg_service_t * p_emg);
+
+// Retira a configuração do Welch escrita pelo client, com os dois campos da
+// mesma escrita. false = nada novo desde a última chamada.
+bool ble_emg_service_take_psd_cfg(ble_emg_service_t * p_emg, uint8_t * p_seg_log2, uint8_t * p_seconds);
+
+// Reescreve o valor legível da configuração do Welch (a que está em uso)
+uint32_t ble_emg_service_update_psd_cfg(ble_emg_service_t * p_emg, uint8_t seg_log2, uint8_t seconds);
+
+// Atualiza o valor legível da PSD e notifica se o client estiver inscrito
+uint32_t ble_emg_service_update_psd(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                     emg_welch_snapshot_t const * p_snap, uint16_t len);
+
+// Decisão do classificador (1 byte): atualiza o valor legível e notifica
+uint32_t ble_emg_service_notify_class(ble_emg_service_t * p_emg, uint16_t conn_handle, uint8_t class_id);
+
+// Atualiza o estado do classificador lido pela característica do modelo
+uint32_t ble_emg_service_update_classifier_status(ble_emg_service_t * p_emg,
+                                                   emg_classifier_status_t const * p_status);
+
+// Atualiza o valor legível das estatísticas de sessão e notifica se inscrito
+uint32_t ble_emg_service_update_stats(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                       emg_stats_snapshot_t const * p_snap);
+
+// Envia um chunk de burst de captura. NRF_ERROR_RESOURCES: fila cheia, tentar de novo
+uint32_t ble_emg_service_notify_capture(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                         emg_capture_chunk_t const * p_chunk, uint16_t len);
+
+// Reescreve o valor legível da configuração de captura a partir dos campos atuais
+uint32_t ble_emg_service_update_capture_cfg(ble_emg_service_t * p_emg);
+
+// Trigger externo com o índice da amostra marcada
+uint32_t ble_emg_service_notify_trigger(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                         emg_trigger_evt_t const * p_evt);
+
+// Envia um chunk da média evocada. NRF_ERROR_RESOURCES: fila cheia, tentar de novo
+uint32_t ble_emg_service_notify_evoked(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                        emg_evoked_chunk_t const * p_chunk, uint16_t len);
+
+// Reescreve o valor legível da configuração da média evocada
+uint32_t ble_emg_service_update_evoked_cfg(ble_emg_service_t * p_emg);
+
+// Co-contração e coerência por par de canais (3 + 10 * n_pairs bytes)
+uint32_t ble_emg_service_notify_cross(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                       emg_cross_snapshot_t const * p_snap, uint16_t len);
+
+// Transição da taxa adaptativa: atualiza o valor legível e notifica
+uint32_t ble_emg_service_notify_rate_mode(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                           emg_rate_evt_t const * p_evt);
+
+// Custo por estágio do pipeline DSP (n x emg_stage_stats_t, ordem da tabela)
+uint32_t ble_emg_service_update_pipeline_stats(ble_emg_service_t * p_emg,
+                                                emg_stage_stats_t const * p_stats, uint8_t n);
+
+// Ocupação, pico e perdas do sample store por view
+uint32_t ble_emg_service_update_store_stats(ble_emg_service_t * p_emg, emg_store_stats_t const * p_stats);
+
+// Pacote do backlog no formato escolhido pelo client (v1: emg_backlog_v1_t,
+// v2: header + amostras RAW), mesmo controle de fluxo do stream
+uint32_t ble_emg_service_notify_backlog(ble_emg_service_t * p_emg, uint16_t conn_handle,
+                                         emg_stream_packet_t const * p_packet);
+
+// Profundidade e tempo de recuperação do backlog
+uint32_t ble_emg_service_update_backlog_stats(ble_emg_service_t * p_emg,
+                                               emg_backlog_stats_t const * p_stats);
+
+// Prazos dos eventos do loop principal (n x emg_sched_stats_t, ordem da tabela)
+uint32_t ble_emg_service_update_sched_stats(ble_emg_service_t * p_emg,
+                                             emg_sched_stats_t const * p_stats, uint8_t n);
+
+// Perfil do link aplicado, parâmetros negociados e vazão por perfil
+uint32_t ble_emg_service_update_link_status(ble_emg_service_t * p_emg, ble_emg_link_status_t const * p_status);
+
+// true se conectado e o client habilitou notificações em alguma característica
+// de sub (EMG_SUB_*). Lê o mapa local, sem chamada à SoftDevice.
+bool ble_emg_service_is_subscribed(ble_emg_service_t const * p_emg, uint16_t sub);
 
 #endif // BLE_EMG_SERVICE_H__
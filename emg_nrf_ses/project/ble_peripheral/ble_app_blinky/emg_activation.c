@@ -0,0 +1,99 @@
+#include "emg_activation.h"
+#include <math.h>
+
+static float    m_x1, m_x2;         // Amostras anteriores (TKEO causal)
+static float    m_energy;           // TKEO suavizado
+static float    m_base_mean;        // Baseline em repouso
+static float    m_base_var;
+static uint32_t m_base_count;
+static bool     m_active;
+static uint16_t m_run;              // Amostras consecutivas além do limiar
+static uint32_t m_run_start;
+static uint32_t m_onset_index;
+
+void emg_activation_init(void)
+{
+    m_x1 = m_x2 = 0.0f;
+    m_energy = 0.0f;
+    m_base_mean = 0.0f;
+    m_base_var = 0.0f;
+    m_base_count = 0;
+    m_active = false;
+    m_run = 0;
+    m_run_start = 0;
+    m_onset_index = 0;
+}
+
+bool emg_activation_is_active(void)
+{
+    return m_active;
+}
+
+bool emg_activation_push(uint32_t sample_index, int16_t sample, emg_activation_evt_t * p_evt)
+{
+    float x = (float)sample;
+
+    // psi[n-1] = x[n-1]² - x[n-2] * x[n]
+    float tkeo = fabsf(m_x1 * m_x1 - m_x2 * x);
+    m_x2 = m_x1;
+    m_x1 = x;
+    m_energy += EMG_ACT_SMOOTH_ALPHA * (tkeo - m_energy);
+
+    // Aprendizado inicial do baseline (Welford)
+    if (m_base_count < EMG_ACT_BASELINE_SAMPLES) {
+        m_base_count++;
+        float diff = m_energy - m_base_mean;
+        m_base_mean += diff / (float)m_base_count;
+        m_base_var  += diff * (m_energy - m_base_mean);
+        if (m_base_count == EMG_ACT_BASELINE_SAMPLES) {
+            m_base_var /= (float)EMG_ACT_BASELINE_SAMPLES;
+        }
+        return false;
+    }
+
+    float std = sqrtf(m_base_var);
+
+    if (!m_active) {
+        if (m_energy > m_base_mean + EMG_ACT_ON_K * std) {
+            if (m_run++ == 0) {
+                m_run_start = sample_index;
+            }
+            if (m_run >= EMG_ACT_MIN_ON_SAMPLES) {
+                m_active = true;
+                m_run = 0;
+                m_onset_index = m_run_start;
+
+                p_evt->type             = EMG_ACT_EVT_ONSET;
+                p_evt->sample_index     = m_onset_index;
+                p_evt->duration_samples = 0;
+                return true;
+            }
+        } else {
+            m_run = 0;
+            // Baseline adaptativo: acompanha deriva do ruído somente em repouso
+            float diff = m_energy - m_base_mean;
+            m_base_mean += EMG_ACT_BASELINE_ALPHA * diff;
+            m_base_var   = (1.0f - EMG_ACT_BASELINE_ALPHA) * (m_base_var + EMG_ACT_BASELINE_ALPHA * diff * diff);
+        }
+    } else {
+        if (m_energy < m_base_mean + EMG_ACT_OFF_K * std) {
+            if (m_run++ == 0) {
+                m_run_start = sample_index;
+            }
+            if (m_run >= EMG_ACT_MIN_OFF_SAMPLES) {
+                uint32_t duration = m_run_start - m_onset_index;
+                m_active = false;
+                m_run = 0;
+
+                p_evt->type             = EMG_ACT_EVT_OFFSET;
+                p_evt->sample_index     = m_run_start;
+                p_evt->duration_samples = (duration > UINT16_MAX) ? UINT16_MAX : (uint16_t)duration;
+                return true;
+            }
+        } else {
+            m_run = 0;
+        }
+    }
+
+    return false;
+}
@@ -0,0 +1,39 @@
+#ifndef EMG_ACTIVATION_H__
+#define EMG_ACTIVATION_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Detector causal de onset/offset de ativação muscular.
+// TKEO (Teager-Kaiser) suavizado + limiar duplo com durações mínimas.
+// O baseline (média/desvio do TKEO em repouso) é aprendido no primeiro
+// segundo e adaptado lentamente enquanto o músculo está inativo.
+#define EMG_ACT_BASELINE_SAMPLES      1000    // 1 s @ 1kSPS de aprendizado inicial
+#define EMG_ACT_SMOOTH_ALPHA          0.05f   // EMA do TKEO (~20 ms)
+#define EMG_ACT_BASELINE_ALPHA        0.001f  // Adaptação do baseline em repouso (~1 s)
+#define EMG_ACT_ON_K                  8.0f    // Onset:  TKEO > média + K_on  * desvio
+#define EMG_ACT_OFF_K                 4.0f    // Offset: TKEO < média + K_off * desvio
+#define EMG_ACT_MIN_ON_SAMPLES        25      // 25 ms acima do limiar para confirmar onset
+#define EMG_ACT_MIN_OFF_SAMPLES       50      // 50 ms abaixo do limiar para confirmar offset
+
+typedef enum {
+    EMG_ACT_EVT_OFFSET = 0,
+    EMG_ACT_EVT_ONSET  = 1,
+} emg_act_evt_type_t;
+
+// Payload da característica de eventos (7 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint8_t  type;              // emg_act_evt_type_t
+    uint32_t sample_index;      // Amostra em que a transição começou (índice absoluto)
+    uint16_t duration_samples;  // Offset: duração da ativação. Onset: 0
+} emg_activation_evt_t;
+
+void emg_activation_init(void);
+
+// Processa uma amostra filtrada de índice absoluto sample_index (mesma base do
+// trigger e do header v2). Retorna true quando um evento foi confirmado.
+bool emg_activation_push(uint32_t sample_index, int16_t sample, emg_activation_evt_t * p_evt);
+
+bool emg_activation_is_active(void);
+
+#endif // EMG_ACTIVATION_H__
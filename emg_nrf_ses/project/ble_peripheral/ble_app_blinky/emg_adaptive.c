@@ -0,0 +1,97 @@
+#include "emg_adaptive.h"
+#include "emg_config.h"
+
+#define REST_HOLD_SAMPLES   ((uint32_t)EMG_ADAPT_REST_HOLD_MS * EMG_SAMPLE_RATE_HZ / 1000u)
+#define WARMUP_SAMPLES      ((uint32_t)EMG_ADAPT_WARMUP_MS * EMG_SAMPLE_RATE_HZ / 1000u)
+
+static bool              m_enabled;
+static emg_adapt_state_t m_state;
+static float             m_fast;            // Envelope rápido (onset)
+static float             m_slow;            // Envelope lento (repouso e piso)
+static float             m_floor;           // Piso de ruído do envelope lento
+static uint32_t          m_warmup;
+static uint32_t          m_quiet;           // Amostras consecutivas abaixo do limiar de repouso
+static uint8_t           m_decim;           // Fase da decimação em REST
+
+void emg_adaptive_init(void)
+{
+    m_enabled  = false;
+    m_state    = EMG_ADAPT_FULL;
+    m_fast     = 0.0f;
+    m_slow     = 0.0f;
+    m_floor    = 0.0f;
+    m_warmup   = 0;
+    m_quiet    = 0;
+    m_decim    = 0;
+}
+
+void emg_adaptive_enable(bool enable)
+{
+    m_enabled = enable;
+    m_quiet   = 0;
+}
+
+bool emg_adaptive_enabled(void)
+{
+    return m_enabled;
+}
+
+emg_adapt_state_t emg_adaptive_state(void)
+{
+    return m_state;
+}
+
+bool emg_adaptive_push(int16_t sample)
+{
+    // REST: uma amostra por conversão do ADC; as repetidas não trazem informação
+    bool rest = (m_state == EMG_ADAPT_REST);
+    if (rest && ++m_decim < EMG_ADAPT_REST_DECIM) {
+        return false;
+    }
+    m_decim = 0;
+
+    float x = (float)(sample < 0 ? -(int32_t)sample : sample);
+    m_fast += (rest ? EMG_ADAPT_REST_ATTACK_ALPHA : EMG_ADAPT_ATTACK_ALPHA) * (x - m_fast);
+    m_slow += (rest ? EMG_ADAPT_REST_SLOW_ALPHA : EMG_ADAPT_SLOW_ALPHA) * (x - m_slow);
+
+    // Piso: desce junto com o envelope lento, sobe devagar só fora da atividade.
+    // Congelado em REST: o ruído a 330 SPS é menor e puxaria o piso para baixo
+    if (!rest) {
+        if (m_warmup < WARMUP_SAMPLES) {
+            m_warmup++;
+            m_floor = m_slow;
+        } else if (m_slow < m_floor) {
+            m_floor = m_slow;
+        } else if (m_slow < EMG_ADAPT_REST_K * m_floor) {
+            m_floor += EMG_ADAPT_FLOOR_RISE * (m_slow - m_floor);
+        }
+    }
+    if (m_floor < 1.0f) {
+        m_floor = 1.0f;     // Entrada parada: evita limiar zero
+    }
+
+    emg_adapt_state_t next = m_state;
+    if (!m_enabled) {
+        next = EMG_ADAPT_FULL;
+    } else if (rest) {
+        if (m_fast > EMG_ADAPT_WAKE_K * EMG_ADAPT_REST_NOISE_SCALE * m_floor) {
+            next = EMG_ADAPT_FULL;
+        }
+    } else if (m_warmup >= WARMUP_SAMPLES) {
+        m_quiet = (m_slow < EMG_ADAPT_REST_K * m_floor) ? m_quiet + 1 : 0;
+        if (m_quiet >= REST_HOLD_SAMPLES) {
+            next = EMG_ADAPT_REST;
+        }
+    }
+
+    if (next == m_state) {
+        return false;
+    }
+    if (rest) {
+        // Envelope lento de volta à escala do ruído em FULL: não derruba o piso
+        m_slow /= EMG_ADAPT_REST_NOISE_SCALE;
+    }
+    m_state = next;
+    m_quiet = 0;
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef EMG_ADAPTIVE_H__
+#define EMG_ADAPTIVE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Taxa adaptativa à atividade: com o envelope abaixo do limiar de repouso por
+// EMG_ADAPT_REST_HOLD_MS o sistema entra em REST (ADC em modo normal de baixa
+// taxa, stream decimado para EMG_ADAPT_REST_RATE_HZ, estágios pesados pulados).
+// O envelope rápido tem ataque de ~2 ms, então a volta para FULL acontece
+// poucos ms após o onset. Os limiares são relativos ao piso de ruído aprendido
+// em FULL. Em REST cada conversão do ADC (330 SPS) chega repetida na grade de
+// 1 kHz: o detector roda uma vez a cada EMG_ADAPT_REST_DECIM amostras, com as
+// constantes da taxa reduzida e o limiar de onset escalado para o ruído menor.
+#define EMG_ADAPT_REST_RATE_HZ        100     // Taxa de saída do stream em repouso
+#define EMG_ADAPT_REST_HOLD_MS        2000    // Tempo abaixo do limiar para entrar em REST
+#define EMG_ADAPT_REST_K              2.0f    // Repouso: envelope lento < K_rest * piso
+#define EMG_ADAPT_WAKE_K              6.0f    // Onset:   envelope rápido > K_wake * piso
+#define EMG_ADAPT_ATTACK_ALPHA        0.4f    // EMA rápida do |x| (~2 ms @ 1 kSPS)
+#define EMG_ADAPT_SLOW_ALPHA          0.01f   // EMA lenta do |x| (~100 ms)
+#define EMG_ADAPT_FLOOR_RISE          0.0005f // Subida lenta do piso (~2 s); descida imediata
+#define EMG_ADAPT_WARMUP_MS           1000    // Aprendizado do piso antes de permitir REST
+#define EMG_ADAPT_REST_DECIM          3       // REST: ~333 Hz, uma vez por conversão a 330 SPS
+#define EMG_ADAPT_REST_ATTACK_ALPHA   0.784f  // Os mesmos ~2 ms: 1 - (1 - 0.4)^3
+#define EMG_ADAPT_REST_SLOW_ALPHA     0.0297f // Os mesmos ~100 ms: 1 - (1 - 0.01)^3
+#define EMG_ADAPT_REST_NOISE_SCALE    0.57f   // Ruído a 330 SPS ~ sqrt(330/1000) do piso em FULL
+
+typedef enum {
+    EMG_ADAPT_FULL = 0,
+    EMG_ADAPT_REST = 1,
+} emg_adapt_state_t;
+
+// Valor da característica de modo de amostragem (9 bytes, little-endian).
+// Notificado a cada transição; o pacote EMG com EMG_QUALITY_FLAG_RATE_CHANGE
+// contém a primeira amostra na nova taxa, na posição packet_offset.
+typedef struct __attribute__((packed)) {
+    uint8_t  adaptive;                // 1 = modo adaptativo ligado
+    uint8_t  state;                   // emg_adapt_state_t
+    uint16_t rate_hz;                 // Taxa de saída do stream a partir da transição
+    uint8_t  packet_offset;
+    uint32_t sample_index;            // Amostra do ADC em que a transição foi decidida
+} emg_rate_evt_t;
+
+void emg_adaptive_init(void);
+
+// Liga/desliga o modo adaptativo (desligado volta a FULL na próxima amostra).
+void emg_adaptive_enable(bool enable);
+
+bool emg_adaptive_enabled(void);
+
+emg_adapt_state_t emg_adaptive_state(void);
+
+// Processa uma amostra filtrada. Retorna true quando o estado mudou.
+bool emg_adaptive_push(int16_t sample);
+
+#endif // EMG_ADAPTIVE_H__
@@ -0,0 +1,86 @@
+#include "emg_backlog.h"
+#include <string.h>
+
+static emg_backlog_record_t m_records[EMG_BACKLOG_PACKETS];
+static uint16_t m_head;                       // Próximo a enviar
+static uint16_t m_count;
+static uint16_t m_high_water;
+static uint16_t m_outages;
+static uint32_t m_stored;
+static uint32_t m_drained;
+static uint32_t m_outage_start_ms;
+static uint32_t m_catch_up_ms;
+
+void emg_backlog_init(void)
+{
+    m_head         = 0;
+    m_count        = 0;
+    m_high_water   = 0;
+    m_outages      = 0;
+    m_stored       = 0;
+    m_drained      = 0;
+    m_catch_up_ms  = 0;
+}
+
+bool emg_backlog_full(void)
+{
+    return m_count >= EMG_BACKLOG_PACKETS;
+}
+
+bool emg_backlog_empty(void)
+{
+    return m_count == 0;
+}
+
+bool emg_backlog_push(void const * p_data, uint32_t now_ms)
+{
+    if (emg_backlog_full()) {
+        return false;
+    }
+    if (m_count == 0) {
+        m_outage_start_ms = now_ms;
+        if (m_outages < UINT16_MAX) {
+            m_outages++;
+        }
+    }
+
+    emg_backlog_record_t * p_rec = &m_records[(m_head + m_count) % EMG_BACKLOG_PACKETS];
+    memcpy(p_rec->data, p_data, EMG_BACKLOG_RECORD_LEN);
+
+    m_count++;
+    m_stored++;
+    if (m_count > m_high_water) {
+        m_high_water = m_count;
+    }
+    return true;
+}
+
+emg_backlog_record_t const * emg_backlog_peek(void)
+{
+    return (m_count == 0) ? NULL : &m_records[m_head];
+}
+
+void emg_backlog_pop(uint32_t now_ms)
+{
+    if (m_count == 0) {
+        return;
+    }
+    m_head = (uint16_t)((m_head + 1) % EMG_BACKLOG_PACKETS);
+    m_count--;
+    m_drained++;
+    if (m_count == 0) {
+        m_catch_up_ms = now_ms - m_outage_start_ms;
+    }
+}
+
+void emg_backlog_get_stats(emg_backlog_stats_t * p_stats, uint32_t now_ms)
+{
+    p_stats->depth          = m_count;
+    p_stats->capacity       = EMG_BACKLOG_PACKETS;
+    p_stats->high_watermark = m_high_water;
+    p_stats->outages        = m_outages;
+    p_stats->stored         = m_stored;
+    p_stats->drained        = m_drained;
+    p_stats->catch_up_ms    = m_catch_up_ms;
+    p_stats->current_ms     = (m_count == 0) ? 0 : now_ms - m_outage_start_ms;
+}
@@ -0,0 +1,49 @@
+#ifndef EMG_BACKLOG_H__
+#define EMG_BACKLOG_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Backlog store-and-forward em RAM: pacotes do stream que não couberam no
+// link (pool de envio esgotado) ficam aqui em ordem, com o header v2 completo
+// (sequência, primeira amostra, taxa, época de ganho). Quando o link volta,
+// são drenados com a capacidade que sobra do stream ao vivo até zerar (catch-up).
+#define EMG_BACKLOG_PACKETS           256     // ~35 KB, ~15 s de stream @ 1kSPS
+#define EMG_BACKLOG_RECORD_LEN        138     // sizeof(emg_stream_packet_t)
+
+// Registro do backlog: o buffer de stream (header v2 + pacote) como foi montado
+typedef struct __attribute__((packed)) {
+    uint8_t  data[EMG_BACKLOG_RECORD_LEN];
+} emg_backlog_record_t;
+
+// Telemetria (24 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint16_t depth;                           // Pacotes aguardando envio
+    uint16_t capacity;                        // EMG_BACKLOG_PACKETS
+    uint16_t high_watermark;                  // Maior profundidade desde o boot
+    uint16_t outages;                         // Vezes que o backlog saiu de vazio
+    uint32_t stored;                          // Pacotes desviados para o backlog
+    uint32_t drained;                         // Pacotes do backlog entregues ao SoftDevice
+    uint32_t catch_up_ms;                     // Última recuperação: 1º pacote desviado → backlog vazio
+    uint32_t current_ms;                      // Duração da recuperação em andamento (0 = nenhuma)
+} emg_backlog_stats_t;
+
+void emg_backlog_init(void);
+
+bool emg_backlog_full(void);
+
+bool emg_backlog_empty(void);
+
+// Copia um pacote para o fim do backlog. now_ms marca o início de uma recuperação.
+// Retorna false se estiver cheio.
+bool emg_backlog_push(void const * p_data, uint32_t now_ms);
+
+// Registro mais antigo (sem remover). NULL se vazio.
+emg_backlog_record_t const * emg_backlog_peek(void);
+
+// Remove o registro mais antigo após o SoftDevice aceitar a notificação.
+void emg_backlog_pop(uint32_t now_ms);
+
+void emg_backlog_get_stats(emg_backlog_stats_t * p_stats, uint32_t now_ms);
+
+#endif // EMG_BACKLOG_H__
@@ -0,0 +1,77 @@
+#include "emg_bandpass.h"
+#include "emg_fir.h"
+#include "emg_config.h"
+#include "emg_platform.h"
+#include <string.h>
+
+// === Butterworth Filter (Order 2, Bandpass 20–400 Hz, Fs = 1000 Hz) ===
+// Bilinear com pré-distorção nas duas bordas (-3 dB em 20 e 400 Hz, ganho
+// unitário em 100 Hz): mesma banda do FIR na taxa de EMG_SAMPLE_RATE_HZ
+#define NZEROS 4
+#define NPOLES 4
+#define GAIN   1.716685748f
+
+// Coeficientes valem só para esta taxa
+EMG_STATIC_ASSERT(EMG_SAMPLE_RATE_HZ == 1000);
+
+EMG_STATIC_ASSERT(sizeof(((emg_butterworth_t *)0)->xv) == (NZEROS + 1) * sizeof(float));
+
+static emg_butterworth_t m_iir;
+
+float emg_butterworth_step(emg_butterworth_t * p_state, float input) {
+    float * xv = p_state->xv;
+    float * yv = p_state->yv;
+    xv[0] = xv[1]; xv[1] = xv[2]; xv[2] = xv[3]; xv[3] = xv[4];
+    xv[4] = input / GAIN;
+    yv[0] = yv[1]; yv[1] = yv[2]; yv[2] = yv[3]; yv[3] = yv[4];
+    yv[4] = (xv[0] + xv[4]) - 2 * xv[2]
+          + (-0.3476653949f * yv[0]) + (-0.1939361276f * yv[1])
+          + (0.8157085862f * yv[2]) + (0.6874450146f * yv[3]);
+    return yv[4];
+}
+
+float butterworth_filter(float input) {
+    return emg_butterworth_step(&m_iir, input);
+}
+
+static emg_bandpass_type_t m_type = EMG_BANDPASS_DEFAULT;
+static emg_fir_t           m_fir;
+
+static void reset_state(void)
+{
+    memset(&m_iir, 0, sizeof(m_iir));
+    emg_fir_init(&m_fir, EMG_BANDPASS_FIR_TAPS);
+}
+
+void emg_bandpass_init(void)
+{
+    m_type = EMG_BANDPASS_DEFAULT;
+    reset_state();
+}
+
+bool emg_bandpass_select(uint8_t type)
+{
+    if (type != EMG_BANDPASS_IIR && type != EMG_BANDPASS_FIR) {
+        return false;
+    }
+    m_type = (emg_bandpass_type_t)type;
+    reset_state();
+    return true;
+}
+
+emg_bandpass_type_t emg_bandpass_type(void)
+{
+    return m_type;
+}
+
+int16_t emg_bandpass_process(int16_t sample)
+{
+    if (m_type == EMG_BANDPASS_FIR) {
+        return emg_fir_process(&m_fir, sample);
+    }
+
+    float y = butterworth_filter((float)sample);
+    if (y > 32767.0f)  y = 32767.0f;
+    if (y < -32768.0f) y = -32768.0f;
+    return (int16_t)y;
+}
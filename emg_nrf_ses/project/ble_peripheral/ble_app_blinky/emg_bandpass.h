@@ -0,0 +1,43 @@
+#ifndef EMG_BANDPASS_H__
+#define EMG_BANDPASS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Estágio passa-banda do pipeline: IIR Butterworth (padrão, baixo custo)
+// ou FIR de fase linear (emg_fir.c), selecionável no build e em runtime.
+typedef enum {
+    EMG_BANDPASS_IIR = 0,
+    EMG_BANDPASS_FIR = 1,
+} emg_bandpass_type_t;
+
+// Seleção de build (pode ser sobrescrita por -D no projeto)
+#ifndef EMG_BANDPASS_DEFAULT
+#define EMG_BANDPASS_DEFAULT          EMG_BANDPASS_IIR
+#endif
+
+#ifndef EMG_BANDPASS_FIR_TAPS
+#define EMG_BANDPASS_FIR_TAPS         127     // 63 ou 127
+#endif
+
+// Estado do IIR por instância (a análise entre canais filtra cada canal)
+typedef struct {
+    float xv[5];
+    float yv[5];
+} emg_butterworth_t;
+
+void emg_bandpass_init(void);
+
+// Troca o filtro em runtime (zera o estado). Retorna false para tipo inválido.
+bool emg_bandpass_select(uint8_t type);
+
+emg_bandpass_type_t emg_bandpass_type(void);
+
+int16_t emg_bandpass_process(int16_t sample);
+
+// Filtro IIR original (float in/out)
+float butterworth_filter(float input);
+
+float emg_butterworth_step(emg_butterworth_t * p_state, float input);
+
+#endif // EMG_BANDPASS_H__
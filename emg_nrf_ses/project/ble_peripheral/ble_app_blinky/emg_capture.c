@@ -0,0 +1,154 @@
+#include "emg_capture.h"
+#include "emg_config.h"
+
+#define RING_MASK       (EMG_CAPTURE_RING_LEN - 1)
+
+typedef enum {
+    STATE_ARMED,        // Gravando histórico, aguardando trigger
+    STATE_POST,         // Gravando amostras pós-trigger
+    STATE_SENDING,      // Janela congelada, enviando chunks
+} capture_state_t;
+
+static int16_t         m_ring[EMG_CAPTURE_RING_LEN];
+static capture_state_t m_state;
+static uint32_t        m_write;           // Total de amostras gravadas (posição de escrita)
+static uint32_t        m_next_index;      // Índice absoluto esperado na próxima amostra
+static uint16_t        m_filled;          // Histórico válido desde o último rearme
+static uint16_t        m_pre_samples;
+static uint16_t        m_post_samples;
+static uint16_t        m_post_remaining;
+static uint32_t        m_trigger_index;   // Posição do trigger no ring
+static uint32_t        m_trigger_sample;  // Índice absoluto da amostra do trigger
+static uint16_t        m_window_pre;      // Pré-trigger efetivo (limitado ao histórico)
+static uint8_t         m_source;
+static uint8_t         m_chunk_index;
+static uint8_t         m_chunk_count;
+static uint16_t        m_burst_seq;
+
+static uint16_t ms_to_samples(uint16_t ms)
+{
+    return (uint16_t)(((uint32_t)ms * EMG_SAMPLE_RATE_HZ) / 1000u);
+}
+
+static void rearm(void)
+{
+    m_state  = STATE_ARMED;
+    m_filled = 0;
+}
+
+void emg_capture_init(void)
+{
+    m_write = 0;
+    m_burst_seq = 0;
+    (void)emg_capture_configure(EMG_CAPTURE_DEFAULT_PRE_MS, EMG_CAPTURE_DEFAULT_POST_MS);
+}
+
+bool emg_capture_configure(uint16_t pre_ms, uint16_t post_ms)
+{
+    uint16_t pre  = ms_to_samples(pre_ms);
+    uint16_t post = ms_to_samples(post_ms);
+
+    if (post == 0 || (uint32_t)pre_ms + post_ms > EMG_CAPTURE_MAX_WINDOW_MS ||
+        (uint32_t)pre + post > EMG_CAPTURE_RING_LEN) {
+        return false;
+    }
+
+    m_pre_samples  = pre;
+    m_post_samples = post;
+    rearm();
+    return true;
+}
+
+void emg_capture_push(uint32_t sample_index, int16_t sample)
+{
+    if (m_state == STATE_SENDING) {
+        return;
+    }
+
+    // Buraco no índice (estágio pulado, bloco perdido): o histórico no ring
+    // deixa de ser contíguo e uma janela pós-trigger não pode atravessá-lo
+    if (m_filled > 0 && sample_index != m_next_index) {
+        rearm();
+    }
+    m_next_index = sample_index + 1;
+
+    if (m_state == STATE_POST && m_post_remaining == m_post_samples) {
+        m_trigger_sample = sample_index;
+    }
+
+    m_ring[m_write & RING_MASK] = sample;
+    m_write++;
+    if (m_filled < EMG_CAPTURE_RING_LEN) {
+        m_filled++;
+    }
+
+    if (m_state == STATE_POST && --m_post_remaining == 0) {
+        uint16_t total = m_window_pre + m_post_samples;
+        m_chunk_count = (uint8_t)((total + EMG_CAPTURE_CHUNK_SAMPLES - 1) / EMG_CAPTURE_CHUNK_SAMPLES);
+        m_chunk_index = 0;
+        m_state = STATE_SENDING;
+    }
+}
+
+bool emg_capture_trigger(uint8_t source)
+{
+    if (m_state != STATE_ARMED) {
+        return false;
+    }
+
+    // A próxima amostra gravada é a do trigger
+    m_trigger_index  = m_write;
+    m_window_pre     = (m_filled < m_pre_samples) ? m_filled : m_pre_samples;
+    m_post_remaining = m_post_samples;
+    m_source         = source;
+    m_state          = STATE_POST;
+    return true;
+}
+
+bool emg_capture_peek_chunk(emg_capture_chunk_t * p_chunk, uint16_t * p_len)
+{
+    if (m_state != STATE_SENDING) {
+        return false;
+    }
+
+    uint16_t total  = m_window_pre + m_post_samples;
+    uint16_t offset = (uint16_t)m_chunk_index * EMG_CAPTURE_CHUNK_SAMPLES;
+    uint16_t n      = total - offset;
+    if (n > EMG_CAPTURE_CHUNK_SAMPLES) {
+        n = EMG_CAPTURE_CHUNK_SAMPLES;
+    }
+
+    uint32_t start = m_trigger_index - m_window_pre + offset;
+    for (uint16_t i = 0; i < n; i++) {
+        p_chunk->samples[i] = m_ring[(start + i) & RING_MASK];
+    }
+
+    p_chunk->burst_seq      = m_burst_seq;
+    p_chunk->chunk_index    = m_chunk_index;
+    p_chunk->chunk_count    = m_chunk_count;
+    p_chunk->source         = m_source;
+    p_chunk->n_samples      = (uint8_t)n;
+    p_chunk->pre_samples    = m_window_pre;
+    p_chunk->trigger_sample = m_trigger_sample;
+
+    *p_len = (uint16_t)(EMG_CAPTURE_HEADER_LEN + n * sizeof(int16_t));
+    return true;
+}
+
+void emg_capture_chunk_sent(void)
+{
+    if (m_state != STATE_SENDING) {
+        return;
+    }
+    if (++m_chunk_index >= m_chunk_count) {
+        m_burst_seq++;
+        rearm();
+    }
+}
+
+void emg_capture_abort(void)
+{
+    if (m_state != STATE_ARMED) {
+        rearm();
+    }
+}
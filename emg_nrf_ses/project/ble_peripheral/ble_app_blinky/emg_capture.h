@@ -0,0 +1,64 @@
+#ifndef EMG_CAPTURE_H__
+#define EMG_CAPTURE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Captura disparada por evento: histórico pré-trigger contínuo em RAM e, após
+// o trigger, as amostras pós-trigger. A janela completa é enviada como um burst
+// de chunks numerados; a gravação fica congelada até o burst terminar.
+#define EMG_CAPTURE_RING_LEN          2048    // Potência de 2, >= pré + pós máximos
+#define EMG_CAPTURE_MAX_WINDOW_MS     2000
+#define EMG_CAPTURE_DEFAULT_PRE_MS    500
+#define EMG_CAPTURE_DEFAULT_POST_MS   1000
+#define EMG_CAPTURE_CHUNK_SAMPLES     60
+
+#define EMG_CAPTURE_CMD_TRIGGER       0x01    // Escrita de 1 byte na configuração: trigger do client
+
+typedef enum {
+    EMG_CAPTURE_MODE_STREAM  = 0,     // Stream contínuo (padrão)
+    EMG_CAPTURE_MODE_TRIGGER = 1,     // Rádio só transmite bursts de captura
+} emg_capture_mode_t;
+
+// Fontes de trigger (máscara habilitada pelo client)
+#define EMG_CAPTURE_SRC_ONSET         0x01
+#define EMG_CAPTURE_SRC_CLIENT        0x02
+#define EMG_CAPTURE_SRC_GPIO          0x04
+
+// Chunk do burst (12 + 2 * n_samples bytes)
+typedef struct __attribute__((packed)) {
+    uint16_t burst_seq;               // Incrementa a cada burst completo
+    uint8_t  chunk_index;
+    uint8_t  chunk_count;
+    uint8_t  source;                  // EMG_CAPTURE_SRC_* que disparou
+    uint8_t  n_samples;
+    uint16_t pre_samples;             // Amostras da janela antes do trigger
+    uint32_t trigger_sample;          // Índice absoluto da amostra do trigger (base do header v2)
+    int16_t  samples[EMG_CAPTURE_CHUNK_SAMPLES];
+} emg_capture_chunk_t;
+
+#define EMG_CAPTURE_HEADER_LEN        12
+
+void emg_capture_init(void);
+
+// Duração em ms da janela pré/pós-trigger (pós >= 1, soma <= EMG_CAPTURE_MAX_WINDOW_MS).
+// Descarta histórico e burst em andamento. Retorna false para valores inválidos.
+bool emg_capture_configure(uint16_t pre_ms, uint16_t post_ms);
+
+// Grava uma amostra filtrada de índice absoluto sample_index (ignorada enquanto
+// um burst é enviado). Um salto no índice descarta o histórico e a janela em curso.
+void emg_capture_push(uint32_t sample_index, int16_t sample);
+
+// Dispara uma captura. Retorna false se já houver uma em andamento.
+bool emg_capture_trigger(uint8_t source);
+
+// Próximo chunk do burst pronto para envio. Retorna false se não houver burst.
+bool emg_capture_peek_chunk(emg_capture_chunk_t * p_chunk, uint16_t * p_len);
+
+// Confirma o envio do chunk obtido em emg_capture_peek_chunk().
+void emg_capture_chunk_sent(void);
+
+// Descarta o burst atual (ex.: client desconectou) e volta a gravar.
+void emg_capture_abort(void);
+
+#endif // EMG_CAPTURE_H__
@@ -0,0 +1,225 @@
+#include "emg_classifier.h"
+#include "emg_platform.h"
+#include <math.h>
+#include <string.h>
+
+typedef struct {
+    uint8_t type;
+    uint8_t n_features;
+    uint8_t n_classes;
+    uint8_t n_hidden;
+    float   mean[EMG_CLF_MAX_FEATURES];
+    float   inv_std[EMG_CLF_MAX_FEATURES];
+    union {
+        struct {
+            float w[EMG_CLF_MAX_CLASSES][EMG_CLF_MAX_FEATURES];
+            float b[EMG_CLF_MAX_CLASSES];
+        } lda;
+        struct {
+            float   in_scale;
+            int8_t  w1[EMG_CLF_MAX_HIDDEN][EMG_CLF_MAX_FEATURES];
+            int32_t b1[EMG_CLF_MAX_HIDDEN];
+            float   h_scale;
+            int8_t  w2[EMG_CLF_MAX_CLASSES][EMG_CLF_MAX_HIDDEN];
+            int32_t b2[EMG_CLF_MAX_CLASSES];
+        } mlp;
+    };
+} model_t;
+
+static uint8_t  m_staging[EMG_CLF_MODEL_MAX_LEN];
+static model_t  m_model;
+static emg_classifier_status_t m_status;
+
+void emg_classifier_init(void)
+{
+    memset(&m_model, 0, sizeof(m_model));
+    memset(&m_status, 0, sizeof(m_status));
+    m_status.last_class = EMG_CLF_CLASS_NONE;
+
+    // Contador de ciclos para medir cada inferência
+    emg_platform_cycles_init();
+}
+
+bool emg_classifier_stage(uint16_t offset, uint8_t const * p_data, uint16_t len)
+{
+    if ((uint32_t)offset + len > EMG_CLF_MODEL_MAX_LEN) {
+        return false;
+    }
+    memcpy(&m_staging[offset], p_data, len);
+    return true;
+}
+
+// Leitura sequencial do blob (sem exigir alinhamento)
+typedef struct {
+    uint8_t const * p;
+    uint16_t        remaining;
+} reader_t;
+
+static bool take(reader_t * p_r, void * p_dst, uint16_t len)
+{
+    if (len > p_r->remaining) {
+        return false;
+    }
+    memcpy(p_dst, p_r->p, len);
+    p_r->p += len;
+    p_r->remaining -= len;
+    return true;
+}
+
+bool emg_classifier_commit(uint16_t len, uint8_t n_features)
+{
+    static model_t model;
+    reader_t r = { m_staging, len };
+    bool ok = true;
+
+    if (len > EMG_CLF_MODEL_MAX_LEN) {
+        return false;
+    }
+
+    memset(&model, 0, sizeof(model));
+    ok &= take(&r, &model.type, 1);
+    ok &= take(&r, &model.n_features, 1);
+    ok &= take(&r, &model.n_classes, 1);
+    ok &= take(&r, &model.n_hidden, 1);
+    if (!ok || model.n_features != n_features || model.n_features > EMG_CLF_MAX_FEATURES ||
+        model.n_classes < 2 || model.n_classes > EMG_CLF_MAX_CLASSES) {
+        return false;
+    }
+
+    uint8_t f = model.n_features;
+    uint8_t c = model.n_classes;
+    uint8_t h = model.n_hidden;
+
+    ok &= take(&r, model.mean, f * sizeof(float));
+    ok &= take(&r, model.inv_std, f * sizeof(float));
+
+    if (model.type == EMG_CLF_MODEL_LDA) {
+        for (uint8_t k = 0; k < c; k++) {
+            ok &= take(&r, model.lda.w[k], f * sizeof(float));
+        }
+        ok &= take(&r, model.lda.b, c * sizeof(float));
+    } else if (model.type == EMG_CLF_MODEL_MLP) {
+        if (h == 0 || h > EMG_CLF_MAX_HIDDEN) {
+            return false;
+        }
+        ok &= take(&r, &model.mlp.in_scale, sizeof(float));
+        for (uint8_t j = 0; j < h; j++) {
+            ok &= take(&r, model.mlp.w1[j], f);
+        }
+        ok &= take(&r, model.mlp.b1, h * sizeof(int32_t));
+        ok &= take(&r, &model.mlp.h_scale, sizeof(float));
+        for (uint8_t k = 0; k < c; k++) {
+            ok &= take(&r, model.mlp.w2[k], h);
+        }
+        ok &= take(&r, model.mlp.b2, c * sizeof(int32_t));
+    } else {
+        return false;
+    }
+
+    // Tamanho exato: blob truncado ou com sobra indica layout errado no host
+    if (!ok || r.remaining != 0) {
+        return false;
+    }
+
+    m_model = model;
+    m_status.model_type = model.type;
+    m_status.n_classes  = model.n_classes;
+    m_status.last_class = EMG_CLF_CLASS_NONE;
+    m_status.max_cycles = 0;
+    m_status.inferences = 0;
+    return true;
+}
+
+bool emg_classifier_ready(void)
+{
+    return m_model.type != EMG_CLF_MODEL_NONE;
+}
+
+static int8_t sat8(float v)
+{
+    v = roundf(v);
+    if (v > 127.0f)  return 127;
+    if (v < -127.0f) return -127;
+    return (int8_t)v;
+}
+
+static uint8_t infer_lda(float const * z)
+{
+    uint8_t best = 0;
+    float best_score = -INFINITY;
+    for (uint8_t k = 0; k < m_model.n_classes; k++) {
+        float score = m_model.lda.b[k];
+        for (uint8_t i = 0; i < m_model.n_features; i++) {
+            score += m_model.lda.w[k][i] * z[i];
+        }
+        if (score > best_score) {
+            best_score = score;
+            best = k;
+        }
+    }
+    return best;
+}
+
+static uint8_t infer_mlp(float const * z)
+{
+    int8_t zq[EMG_CLF_MAX_FEATURES];
+    int8_t hq[EMG_CLF_MAX_HIDDEN];
+
+    for (uint8_t i = 0; i < m_model.n_features; i++) {
+        zq[i] = sat8(z[i] * m_model.mlp.in_scale);
+    }
+
+    for (uint8_t j = 0; j < m_model.n_hidden; j++) {
+        int32_t acc = m_model.mlp.b1[j];
+        for (uint8_t i = 0; i < m_model.n_features; i++) {
+            acc += (int32_t)m_model.mlp.w1[j][i] * zq[i];
+        }
+        hq[j] = (acc > 0) ? sat8((float)acc * m_model.mlp.h_scale) : 0;   // ReLU
+    }
+
+    uint8_t best = 0;
+    int32_t best_score = INT32_MIN;
+    for (uint8_t k = 0; k < m_model.n_classes; k++) {
+        int32_t acc = m_model.mlp.b2[k];
+        for (uint8_t j = 0; j < m_model.n_hidden; j++) {
+            acc += (int32_t)m_model.mlp.w2[k][j] * hq[j];
+        }
+        if (acc > best_score) {
+            best_score = acc;
+            best = k;
+        }
+    }
+    return best;
+}
+
+bool emg_classifier_infer(float const * p_feat, uint8_t * p_class)
+{
+    if (!emg_classifier_ready()) {
+        return false;
+    }
+
+    uint32_t start = emg_platform_cycles();
+
+    float z[EMG_CLF_MAX_FEATURES];
+    for (uint8_t i = 0; i < m_model.n_features; i++) {
+        z[i] = (p_feat[i] - m_model.mean[i]) * m_model.inv_std[i];
+    }
+
+    uint8_t cls = (m_model.type == EMG_CLF_MODEL_LDA) ? infer_lda(z) : infer_mlp(z);
+
+    uint32_t cycles = emg_platform_cycles() - start;
+    m_status.last_cycles = cycles;
+    if (cycles > m_status.max_cycles) {
+        m_status.max_cycles = cycles;
+    }
+    m_status.inferences++;
+    m_status.last_class = cls;
+
+    *p_class = cls;
+    return true;
+}
+
+void emg_classifier_status(emg_classifier_status_t * p_status)
+{
+    *p_status = m_status;
+}
@@ -0,0 +1,56 @@
+#ifndef EMG_CLASSIFIER_H__
+#define EMG_CLASSIFIER_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Classificador de gestos embarcado sobre vetores de features.
+// O modelo é treinado no host e carregado via BLE como um blob little-endian:
+//
+//   uint8 type, uint8 n_features (F), uint8 n_classes (C), uint8 n_hidden (H)
+//   float mean[F], float inv_std[F]              // padronização z = (x - mean) * inv_std
+//   LDA: float w[C][F], float b[C]               // argmax(w·z + b)
+//   MLP: float in_scale                          // z_q = sat8(round(z * in_scale))
+//        int8 w1[H][F], int32 b1[H]              // h = relu(w1·z_q + b1)
+//        float h_scale                           // h_q = sat8(round(h * h_scale))
+//        int8 w2[C][H], int32 b2[C]              // argmax(w2·h_q + b2)
+#define EMG_CLF_MAX_FEATURES          8
+#define EMG_CLF_MAX_CLASSES           8
+#define EMG_CLF_MAX_HIDDEN            16
+#define EMG_CLF_MODEL_MAX_LEN         512     // Cobre o maior MLP (428 bytes)
+
+#define EMG_CLF_CLASS_NONE            0xFF    // Nenhum modelo carregado
+
+typedef enum {
+    EMG_CLF_MODEL_NONE = 0,
+    EMG_CLF_MODEL_LDA  = 1,
+    EMG_CLF_MODEL_MLP  = 2,
+} emg_clf_model_type_t;
+
+// Estado legível pela característica do modelo (15 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint8_t  model_type;              // emg_clf_model_type_t ativo
+    uint8_t  n_classes;
+    uint8_t  last_class;
+    uint32_t last_cycles;             // Ciclos de CPU da última inferência (DWT)
+    uint32_t max_cycles;
+    uint32_t inferences;
+} emg_classifier_status_t;
+
+void emg_classifier_init(void);
+
+// Copia um trecho do blob para a área de staging (não afeta o modelo ativo).
+bool emg_classifier_stage(uint16_t offset, uint8_t const * p_data, uint16_t len);
+
+// Valida os len bytes em staging e troca o modelo ativo. O modelo precisa usar
+// exatamente n_features (o vetor produzido pelo pipeline). Chamar fora do contexto BLE.
+bool emg_classifier_commit(uint16_t len, uint8_t n_features);
+
+bool emg_classifier_ready(void);
+
+// Classifica um vetor com n_features valores. Retorna false sem modelo.
+bool emg_classifier_infer(float const * p_feat, uint8_t * p_class);
+
+void emg_classifier_status(emg_classifier_status_t * p_status);
+
+#endif // EMG_CLASSIFIER_H__
@@ -0,0 +1,304 @@
+#include "emg_codec.h"
+#include <string.h>
+
+#define N_BANDS         3
+#define RICE_K_MAX      15
+#define RICE_ESCAPE     16      // Quociente a partir do qual o valor vai em ESCAPE_BITS
+#define ESCAPE_BITS     19      // zigzag de |c| <= ~131072 (s1 chega a ±65536, d2/s2 ao dobro)
+#define COEF_LIMIT      (1L << 20)  // |c| decodificado acima disso = pacote inválido (lifting em int32)
+
+typedef struct {
+    uint8_t * p_buf;
+    uint16_t  max_bytes;
+    uint32_t  bit;
+    bool      overflow;
+} bit_writer_t;
+
+typedef struct {
+    uint8_t const * p_buf;
+    uint16_t        len_bytes;
+    uint32_t        bit;
+    bool            underflow;
+} bit_reader_t;
+
+// === Wavelet 5/3 inteira (lifting, extensão simétrica, n par) ===
+
+static void fwd53(int32_t const * x, uint16_t n, int32_t * s, int32_t * d)
+{
+    uint16_t h = n / 2;
+    for (uint16_t i = 0; i < h; i++) {
+        int32_t right = (2 * i + 2 < n) ? x[2 * i + 2] : x[2 * i];
+        d[i] = x[2 * i + 1] - ((x[2 * i] + right) >> 1);
+    }
+    for (uint16_t i = 0; i < h; i++) {
+        int32_t left = (i > 0) ? d[i - 1] : d[0];
+        s[i] = x[2 * i] + ((left + d[i] + 2) >> 2);
+    }
+}
+
+static void inv53(int32_t const * s, int32_t const * d, uint16_t n, int32_t * x)
+{
+    uint16_t h = n / 2;
+    for (uint16_t i = 0; i < h; i++) {
+        int32_t left = (i > 0) ? d[i - 1] : d[0];
+        x[2 * i] = s[i] - ((left + d[i] + 2) >> 2);
+    }
+    for (uint16_t i = 0; i < h; i++) {
+        int32_t right = (i + 1 < h) ? x[2 * i + 2] : x[2 * i];
+        x[2 * i + 1] = d[i] + ((x[2 * i] + right) >> 1);
+    }
+}
+
+// Layout dos coeficientes: [s2 (n/4) | d2 (n/4) | d1 (n/2)]
+static void forward(int32_t const * x, uint8_t n, int32_t * c)
+{
+    int32_t s1[EMG_CODEC_MAX_SAMPLES / 2];
+    fwd53(x, n, s1, &c[n / 2]);
+    fwd53(s1, n / 2, &c[0], &c[n / 4]);
+}
+
+static void inverse(int32_t const * c, uint8_t n, int32_t * x)
+{
+    int32_t s1[EMG_CODEC_MAX_SAMPLES / 2];
+    inv53(&c[0], &c[n / 4], n / 2, s1);
+    inv53(s1, &c[n / 2], n, x);
+}
+
+// === Quantização ===
+
+static int32_t quantize(int32_t c, uint16_t step)
+{
+    int32_t half = step / 2;
+    return (c >= 0) ? (c + half) / step : -((-c + half) / step);
+}
+
+// === Rice ===
+
+static void put_bits(bit_writer_t * p_w, uint32_t value, uint8_t count)
+{
+    while (count--) {
+        uint32_t byte = p_w->bit >> 3;
+        if (byte >= p_w->max_bytes) {
+            p_w->overflow = true;
+            return;
+        }
+        uint8_t mask = (uint8_t)(0x80 >> (p_w->bit & 7));
+        if ((value >> count) & 1) {
+            p_w->p_buf[byte] |= mask;
+        } else {
+            p_w->p_buf[byte] &= (uint8_t)~mask;
+        }
+        p_w->bit++;
+    }
+}
+
+static uint32_t get_bits(bit_reader_t * p_r, uint8_t count)
+{
+    uint32_t value = 0;
+    while (count--) {
+        uint32_t byte = p_r->bit >> 3;
+        if (byte >= p_r->len_bytes) {
+            p_r->underflow = true;
+            return 0;
+        }
+        value = (value << 1) | ((p_r->p_buf[byte] >> (7 - (p_r->bit & 7))) & 1);
+        p_r->bit++;
+    }
+    return value;
+}
+
+static uint32_t zigzag(int32_t v)
+{
+    return (v >= 0) ? ((uint32_t)v << 1) : (((uint32_t)(-v) << 1) - 1);
+}
+
+static int32_t unzigzag(uint32_t u)
+{
+    return (u & 1) ? -(int32_t)((u + 1) >> 1) : (int32_t)(u >> 1);
+}
+
+static uint8_t rice_k(int32_t const * q, uint8_t count)
+{
+    uint32_t sum = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        sum += zigzag(q[i]);
+    }
+    uint8_t k = 0;
+    while (k < RICE_K_MAX && ((uint32_t)count << (k + 1)) <= sum) {
+        k++;
+    }
+    return k;
+}
+
+static void rice_put(bit_writer_t * p_w, uint32_t u, uint8_t k)
+{
+    uint32_t quotient = u >> k;
+    if (quotient >= RICE_ESCAPE) {
+        put_bits(p_w, (1u << RICE_ESCAPE) - 1, RICE_ESCAPE);
+        put_bits(p_w, u, ESCAPE_BITS);
+        return;
+    }
+    put_bits(p_w, (1u << (quotient + 1)) - 2, (uint8_t)(quotient + 1));  // quotient "1"s e um "0"
+    put_bits(p_w, u & ((1u << k) - 1), k);
+}
+
+static uint32_t rice_get(bit_reader_t * p_r, uint8_t k)
+{
+    uint32_t quotient = 0;
+    while (quotient < RICE_ESCAPE && get_bits(p_r, 1) && !p_r->underflow) {
+        quotient++;
+    }
+    if (quotient >= RICE_ESCAPE) {
+        return get_bits(p_r, ESCAPE_BITS);
+    }
+    return (quotient << k) | get_bits(p_r, k);
+}
+
+static void band_layout(uint8_t n, uint8_t * p_start, uint8_t * p_len)
+{
+    p_start[0] = 0;         p_len[0] = n / 4;   // s2
+    p_start[1] = n / 4;     p_len[1] = n / 4;   // d2
+    p_start[2] = n / 2;     p_len[2] = n / 2;   // d1
+}
+
+// === API ===
+
+static uint16_t encode_raw(void const * p_in, uint8_t n, emg_codec_packet_t * p_pkt)
+{
+    p_pkt->encoding = EMG_ENCODING_RAW;
+    p_pkt->step = 0;
+    memcpy(p_pkt->data, p_in, n * sizeof(int16_t));
+    return (uint16_t)(EMG_CODEC_HEADER_LEN + n * sizeof(int16_t));
+}
+
+uint16_t emg_codec_encode(void const * p_in, uint8_t n, uint16_t max_error,
+                          uint16_t quality_flags, emg_codec_packet_t * p_pkt)
+{
+    int32_t x[EMG_CODEC_MAX_SAMPLES];
+    int32_t c[EMG_CODEC_MAX_SAMPLES];
+    int32_t q[EMG_CODEC_MAX_SAMPLES];
+    int32_t dq[EMG_CODEC_MAX_SAMPLES];
+    int32_t r[EMG_CODEC_MAX_SAMPLES];
+
+    p_pkt->n_samples     = n;
+    p_pkt->quality_flags = quality_flags;
+
+    if (n == 0 || n > EMG_CODEC_MAX_SAMPLES || (n % 4) != 0) {
+        return encode_raw(p_in, (n > EMG_CODEC_MAX_SAMPLES) ? EMG_CODEC_MAX_SAMPLES : n, p_pkt);
+    }
+
+    uint8_t const * p_bytes = (uint8_t const *)p_in;
+    for (uint8_t i = 0; i < n; i++) {
+        int16_t v;
+        memcpy(&v, &p_bytes[i * sizeof(int16_t)], sizeof(v));
+        x[i] = v;
+    }
+    forward(x, n, c);
+
+    // Passo inicial ótimo para transformada identidade; reduz até respeitar o limite
+    uint32_t step32 = 2u * max_error + 1u;
+    uint16_t step = (step32 > UINT16_MAX) ? UINT16_MAX : (uint16_t)step32;
+    for (;;) {
+        for (uint8_t i = 0; i < n; i++) {
+            q[i] = quantize(c[i], step);
+            dq[i] = q[i] * step;
+        }
+        inverse(dq, n, r);
+
+        uint32_t worst = 0;
+        for (uint8_t i = 0; i < n; i++) {
+            int32_t e = r[i] - x[i];
+            uint32_t abs_e = (uint32_t)((e < 0) ? -e : e);
+            if (abs_e > worst) worst = abs_e;
+        }
+        if (worst <= max_error || step == 1) {
+            break;
+        }
+        step = (uint16_t)(step - ((step / 4 > 0) ? step / 4 : 1));
+    }
+
+    uint8_t start[N_BANDS], len[N_BANDS];
+    band_layout(n, start, len);
+
+    bit_writer_t w = { p_pkt->data, (uint16_t)(n * sizeof(int16_t)), 0, false };
+    for (uint8_t b = 0; b < N_BANDS; b++) {
+        uint8_t k = rice_k(&q[start[b]], len[b]);
+        put_bits(&w, k, 4);
+        for (uint8_t i = 0; i < len[b]; i++) {
+            rice_put(&w, zigzag(q[start[b] + i]), k);
+        }
+    }
+
+    if (w.overflow) {
+        return encode_raw(p_in, n, p_pkt);
+    }
+
+    p_pkt->encoding = EMG_ENCODING_WAVELET;
+    p_pkt->step     = step;
+    uint16_t pkt_len = (uint16_t)(EMG_CODEC_HEADER_LEN + ((w.bit + 7) >> 3));
+
+    // O limite vale para o que o client recebe: confere decodificando o bitstream
+    int16_t check[EMG_CODEC_MAX_SAMPLES];
+    if (emg_codec_decode(p_pkt, pkt_len, check) != n) {
+        return encode_raw(p_in, n, p_pkt);
+    }
+    for (uint8_t i = 0; i < n; i++) {
+        int32_t e = (int32_t)check[i] - x[i];
+        if ((uint32_t)((e < 0) ? -e : e) > max_error) {
+            return encode_raw(p_in, n, p_pkt);
+        }
+    }
+    return pkt_len;
+}
+
+uint8_t emg_codec_decode(emg_codec_packet_t const * p_pkt, uint16_t len, int16_t * p_out)
+{
+    // Cabeçalho conferido antes de ler qualquer campo
+    if (len < EMG_CODEC_HEADER_LEN) {
+        return 0;
+    }
+    uint8_t n = p_pkt->n_samples;
+    if (n == 0 || n > EMG_CODEC_MAX_SAMPLES) {
+        return 0;
+    }
+
+    if (p_pkt->encoding == EMG_ENCODING_RAW) {
+        if (len < EMG_CODEC_HEADER_LEN + n * sizeof(int16_t)) {
+            return 0;
+        }
+        memcpy(p_out, p_pkt->data, n * sizeof(int16_t));
+        return n;
+    }
+
+    if (p_pkt->encoding != EMG_ENCODING_WAVELET || (n % 4) != 0 || p_pkt->step == 0) {
+        return 0;
+    }
+
+    int32_t c[EMG_CODEC_MAX_SAMPLES];
+    int32_t x[EMG_CODEC_MAX_SAMPLES];
+    uint8_t start[N_BANDS], blen[N_BANDS];
+    band_layout(n, start, blen);
+
+    bit_reader_t r = { p_pkt->data, (uint16_t)(len - EMG_CODEC_HEADER_LEN), 0, false };
+    for (uint8_t b = 0; b < N_BANDS; b++) {
+        uint8_t k = (uint8_t)get_bits(&r, 4);
+        for (uint8_t i = 0; i < blen[b]; i++) {
+            // Pacote malformado não pode estourar o int32 do lifting
+            int64_t v = (int64_t)unzigzag(rice_get(&r, k)) * p_pkt->step;
+            if (v > COEF_LIMIT || v < -COEF_LIMIT) {
+                return 0;
+            }
+            c[start[b] + i] = (int32_t)v;
+        }
+    }
+    if (r.underflow) {
+        return 0;
+    }
+
+    inverse(c, n, x);
+    for (uint8_t i = 0; i < n; i++) {
+        int32_t v = x[i];
+        p_out[i] = (int16_t)((v > INT16_MAX) ? INT16_MAX : (v < INT16_MIN) ? INT16_MIN : v);
+    }
+    return n;
+}
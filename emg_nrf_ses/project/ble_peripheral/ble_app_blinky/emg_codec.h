@@ -0,0 +1,42 @@
+#ifndef EMG_CODEC_H__
+#define EMG_CODEC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Codec com perda e erro máximo garantido para o stream EMG.
+//   1. Wavelet inteira 5/3 (lifting, reversível) em 2 níveis: s2 | d2 | d1
+//   2. Quantização uniforme; o encoder reconstrói o bloco e reduz o passo
+//      até |x - x'| <= max_error em todas as amostras (passo 1 = sem perda)
+//   3. Rice adaptativo por sub-banda (k de 4 bits por banda, escape de 19 bits:
+//      coeficientes de um degrau de fundo de escala chegam a ~±131072)
+// O encoder decodifica o bitstream emitido e confere o limite; se não couber
+// ou não conferir, o pacote vai como int16 cru (EMG_ENCODING_RAW).
+#define EMG_CODEC_MAX_SAMPLES         60      // Múltiplo de 4 (dois níveis de decimação)
+
+typedef enum {
+    EMG_ENCODING_RAW     = 0,     // int16_t little-endian
+    EMG_ENCODING_WAVELET = 1,
+} emg_encoding_t;
+
+// Pacote codificado (6 + até 2 * EMG_CODEC_MAX_SAMPLES bytes)
+typedef struct __attribute__((packed)) {
+    uint8_t  encoding;            // emg_encoding_t do bloco
+    uint8_t  n_samples;
+    uint16_t step;                // Passo de quantização usado (WAVELET)
+    uint16_t quality_flags;
+    uint8_t  data[2 * EMG_CODEC_MAX_SAMPLES];
+} emg_codec_packet_t;
+
+#define EMG_CODEC_HEADER_LEN          6
+
+// Codifica n amostras int16 (múltiplo de 4, <= EMG_CODEC_MAX_SAMPLES); p_in não
+// precisa estar alinhado (ex.: campo de struct packed).
+// Retorna o tamanho total do pacote em bytes (cabeçalho incluído).
+uint16_t emg_codec_encode(void const * p_in, uint8_t n, uint16_t max_error,
+                          uint16_t quality_flags, emg_codec_packet_t * p_pkt);
+
+// Decodifica um pacote de len bytes. Retorna o número de amostras ou 0 se inválido.
+uint8_t emg_codec_decode(emg_codec_packet_t const * p_pkt, uint16_t len, int16_t * p_out);
+
+#endif // EMG_CODEC_H__
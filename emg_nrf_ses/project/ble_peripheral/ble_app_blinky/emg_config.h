@@ -0,0 +1,25 @@
+#ifndef EMG_CONFIG_H__
+#define EMG_CONFIG_H__
+
+// Parâmetros de aquisição compartilhados pelos módulos de DSP.
+// A taxa deve acompanhar o data_rate configurado em ADS112C04.c.
+#define EMG_SAMPLE_RATE_HZ            1000
+
+// Canais do ADC amostrados em sequência pelo MUX do ADS112C04 (taxa acima é por
+// canal: o ADC converte a EMG_SAMPLE_RATE_HZ * EMG_CHANNEL_COUNT). O canal 0
+// alimenta o pipeline principal; variantes multi-site ligam a análise entre
+// canais (emg_cross.c). O build de host aceita 2..4; no firmware o orçamento de
+// tempo do ADS112C04 (conversão reiniciada a cada troca de MUX + I2C) não fecha
+// 1 kHz por canal nem com 2 canais, e main.c recusa o build (#error).
+#ifndef EMG_CHANNEL_COUNT
+#define EMG_CHANNEL_COUNT             1
+#endif
+
+// Variante FreeRTOS (projeto ble_app_blinky_freertos_*.emProject, -DEMG_RTOS=1):
+// aquisição acordada pelo DRDY, DSP e rádio em tarefas de prioridades
+// decrescentes (emg_sched_freertos.c). 0 = loop único sobre o app_scheduler.
+#ifndef EMG_RTOS
+#define EMG_RTOS                      0
+#endif
+
+#endif // EMG_CONFIG_H__
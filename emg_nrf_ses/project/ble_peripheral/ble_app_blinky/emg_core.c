@@ -0,0 +1,343 @@
+#include "emg_core.h"
+#include "emg_config.h"
+#include "emg_platform.h"
+#include "emg_pipeline.h"
+#include "emg_store.h"
+#include "emg_decimator.h"
+#include "emg_quality.h"
+#include "emg_prefilter.h"
+#include "emg_bandpass.h"
+#include "emg_adaptive.h"
+#include "emg_features.h"
+#include "emg_capture.h"
+#include "emg_evoked.h"
+#include "emg_cross.h"
+
+#define CORE_STREAM_CHUNK   64      // Frames por trecho contíguo lido do store
+
+static emg_core_platform_t const * m_platform;
+
+static bool     m_capture_mode = false;
+static uint8_t  m_capture_triggers;
+static uint8_t  m_last_class   = EMG_CLF_CLASS_NONE;
+static uint32_t m_block_index  = 0;     // Índice absoluto da primeira amostra do bloco
+static volatile bool m_rate_switch = false; // Transição da taxa adaptativa (aplicada no stream)
+static uint32_t m_rate_switch_index;
+static uint8_t  m_gain_level = 0xFF;
+
+static uint16_t stage_quality(int16_t * p_block, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        emg_quality_push_raw(p_block[i]);
+    }
+    return n;
+}
+
+// Bruto e filtrado vão para os mesmos frames do store (escrita em duas fases)
+static uint16_t stage_store_raw(int16_t * p_block, uint16_t n)
+{
+    emg_store_write_raw(p_block, n, m_block_index);
+    return n;
+}
+
+static uint16_t stage_store(int16_t * p_block, uint16_t n)
+{
+    emg_store_write_filtered(p_block, n);
+    return n;
+}
+
+static uint16_t stage_offset(int16_t * p_block, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        p_block[i] = emg_offset_process(p_block[i]);
+    }
+    return n;
+}
+
+#if EMG_PIPELINE_NOTCH
+static uint16_t stage_notch(int16_t * p_block, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        p_block[i] = emg_notch_process(p_block[i]);
+    }
+    return n;
+}
+#endif
+
+static uint16_t stage_bandpass(int16_t * p_block, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        p_block[i] = emg_bandpass_process(p_block[i]);
+    }
+    return n;
+}
+
+// Onset/offset: evento compacto com o índice exato da amostra
+static uint16_t stage_activation(int16_t * p_block, uint16_t n)
+{
+    emg_activation_evt_t evt;
+    for (uint16_t i = 0; i < n; i++) {
+        if (!emg_activation_push(m_block_index + i, p_block[i], &evt)) {
+            continue;
+        }
+        if (evt.type == EMG_ACT_EVT_ONSET) {
+            emg_core_capture_trigger(EMG_CAPTURE_SRC_ONSET);
+        }
+        EMG_LOG_INFO("Activation %s @ sample %d",
+                     evt.type == EMG_ACT_EVT_ONSET ? "onset" : "offset", evt.sample_index);
+        if (m_platform->activation != NULL) {
+            m_platform->activation(&evt);
+        }
+    }
+    return n;
+}
+
+// Taxa adaptativa: envelope do sinal filtrado decide FULL/REST (aplicado no stream)
+static uint16_t stage_adaptive(int16_t * p_block, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        if (emg_adaptive_push(p_block[i])) {
+            m_rate_switch = true;
+            m_rate_switch_index = m_block_index + i;
+        }
+    }
+    return n;
+}
+
+// Estatísticas de sessão (percentis P², duty cycle), publicadas a cada 1 s
+static uint16_t stage_stats(int16_t * p_block, uint16_t n)
+{
+    emg_stats_snapshot_t snapshot;
+    for (uint16_t i = 0; i < n; i++) {
+        if (emg_stats_push(p_block[i], emg_activation_is_active(), &snapshot) &&
+            m_platform->stats != NULL) {
+            m_platform->stats(&snapshot);
+        }
+    }
+    return n;
+}
+
+// MNF/MDF por janela — só a notificação de baixa taxa vai ao rádio
+static uint16_t stage_spectral(int16_t * p_block, uint16_t n)
+{
+    emg_fatigue_metrics_t metrics;
+    for (uint16_t i = 0; i < n; i++) {
+        if (emg_spectral_push(p_block[i], &metrics) && m_platform->fatigue != NULL) {
+            m_platform->fatigue(&metrics);
+        }
+    }
+    return n;
+}
+
+static bool spectral_enabled(void)
+{
+    return emg_core_full_rate() &&
+           m_platform->fatigue_subscribed != NULL && m_platform->fatigue_subscribed();
+}
+
+// PSD de Welch: snapshot a cada janela de N segundos (legível mesmo sem inscrição)
+static uint16_t stage_welch(int16_t * p_block, uint16_t n)
+{
+    static emg_welch_snapshot_t snapshot;
+    uint16_t len;
+    for (uint16_t i = 0; i < n; i++) {
+        if (emg_welch_push(p_block[i], &snapshot, &len) && m_platform->psd != NULL) {
+            m_platform->psd(&snapshot, len);
+        }
+    }
+    return n;
+}
+
+// Decisão do classificador a cada hop de features (40 Hz); notifica só mudanças
+static uint16_t stage_classifier(int16_t * p_block, uint16_t n)
+{
+    float features[EMG_FEAT_COUNT];
+    uint8_t class_id;
+    for (uint16_t i = 0; i < n; i++) {
+        if (!emg_features_push(p_block[i], features) || !emg_classifier_infer(features, &class_id)) {
+            continue;
+        }
+        emg_classifier_status_t clf_status;
+        emg_classifier_status(&clf_status);
+        if (class_id != m_last_class) {
+            m_last_class = class_id;
+            if (m_platform->class_changed != NULL) {
+                m_platform->class_changed(class_id);
+            }
+        }
+        if (clf_status.inferences % 40 == 0 && m_platform->classifier_status != NULL) {
+            m_platform->classifier_status(&clf_status);
+        }
+    }
+    return n;
+}
+
+static uint16_t stage_capture(int16_t * p_block, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        emg_capture_push(m_block_index + i, p_block[i]);
+    }
+    return n;
+}
+
+static bool classifier_enabled(void)
+{
+    return emg_core_full_rate() && emg_classifier_ready();
+}
+
+static bool capture_enabled(void)
+{
+    return m_capture_mode;
+}
+
+// Média coerente: épocas alinhadas pelo índice absoluto da amostra do trigger
+static uint16_t stage_evoked(int16_t * p_block, uint16_t n)
+{
+    for (uint16_t i = 0; i < n; i++) {
+        emg_evoked_push(m_block_index + i, p_block[i]);
+    }
+    return n;
+}
+
+static const emg_stage_t m_pipeline[] = {
+    { "quality",    stage_quality,    NULL },             // Sinal bruto do ADC
+    { "store_raw",  stage_store_raw,  emg_store_any_active },
+    { "offset",     stage_offset,     NULL },
+#if EMG_PIPELINE_NOTCH
+    { "notch",      stage_notch,      NULL },
+#endif
+    { "bandpass",   stage_bandpass,   NULL },
+    { "store",      stage_store,      emg_store_any_active },  // Mesmo predicado de store_raw
+    { "adaptive",   stage_adaptive,   NULL },             // Detecta repouso/onset em poucos ms
+    { "activation", stage_activation, NULL },             // Antes de stats/captura (duty cycle, trigger)
+    { "stats",      stage_stats,      NULL },
+    { "spectral",   stage_spectral,   spectral_enabled },
+    { "welch",      stage_welch,      NULL },
+    { "classifier", stage_classifier, classifier_enabled },  // Pulado em repouso
+    { "capture",    stage_capture,    capture_enabled },
+    { "evoked",     stage_evoked,     emg_evoked_enabled },
+};
+
+bool emg_core_init(emg_core_platform_t const * p_platform)
+{
+    m_platform = p_platform;
+
+    emg_spectral_init();
+    emg_activation_init();
+    emg_decimator_init();
+    emg_quality_init();
+    emg_bandpass_init();
+    emg_welch_init();
+    emg_features_init();
+    emg_classifier_init();
+    emg_stats_init();
+    emg_capture_init();
+    emg_prefilter_init();
+    emg_store_init();
+    emg_evoked_init();
+    emg_adaptive_init();
+#if EMG_CHANNEL_COUNT > 1
+    emg_cross_init();
+#endif
+    return emg_pipeline_init(m_pipeline, sizeof(m_pipeline) / sizeof(m_pipeline[0]));
+}
+
+uint16_t emg_core_process_block(int16_t * p_block, uint16_t n, uint32_t first_index)
+{
+    m_block_index = first_index;
+    return emg_pipeline_run(p_block, n);
+}
+
+#if EMG_CHANNEL_COUNT > 1
+// Co-contração/coerência por par: uma FFT por canal a cada janela
+void emg_core_process_frames(int16_t const (*p_frames)[EMG_CHANNEL_COUNT], uint16_t n)
+{
+    static emg_cross_snapshot_t snapshot;
+    uint16_t len;
+    for (uint16_t i = 0; i < n; i++) {
+        if (emg_cross_push(p_frames[i], &snapshot, &len) && m_platform->cross != NULL) {
+            m_platform->cross(&snapshot, len);
+        }
+    }
+}
+#endif
+
+// Stream filtrado: lê a view do store e decima na taxa pedida pelo client
+EMG_STATIC_ASSERT(EMG_DECIM_MAX_OUT == 1);
+
+bool emg_core_stream_pop(int16_t * p_out, uint32_t * p_index)
+{
+    emg_store_frame_t const * p_frames;
+    uint16_t n;
+    // Trecho contíguo por vez: uma barreira por bloco, não por amostra
+    while ((n = emg_store_peek(EMG_STORE_VIEW_FILTERED, 0, &p_frames, CORE_STREAM_CHUNK)) > 0) {
+        for (uint16_t i = 0; i < n; i++) {
+            int16_t decimated[EMG_DECIM_MAX_OUT];
+            if (emg_decimator_process(p_frames[i].filtered, decimated) > 0) {
+                if (p_index != NULL) {
+                    *p_index = emg_store_sample_index(EMG_STORE_VIEW_FILTERED, i);
+                }
+                emg_store_consume(EMG_STORE_VIEW_FILTERED, i + 1);
+                *p_out = decimated[0];
+                return true;
+            }
+        }
+        emg_store_consume(EMG_STORE_VIEW_FILTERED, n);
+    }
+    return false;
+}
+
+bool emg_core_take_rate_switch(uint32_t * p_sample_index)
+{
+    if (!m_rate_switch) {
+        return false;
+    }
+    m_rate_switch = false;
+    *p_sample_index = m_rate_switch_index;
+    return true;
+}
+
+bool emg_core_full_rate(void)
+{
+    return emg_adaptive_state() == EMG_ADAPT_FULL;
+}
+
+void emg_core_set_capture(bool enabled, uint8_t triggers)
+{
+    m_capture_mode     = enabled;
+    m_capture_triggers = triggers;
+}
+
+bool emg_core_capture_mode(void)
+{
+    return m_capture_mode;
+}
+
+void emg_core_capture_trigger(uint8_t source)
+{
+    if (m_capture_mode && (m_capture_triggers & source)) {
+        (void)emg_capture_trigger(source);
+    }
+}
+
+void emg_core_class_reset(void)
+{
+    m_last_class = EMG_CLF_CLASS_NONE;
+}
+
+bool emg_core_set_gain(uint8_t level)
+{
+    if (level < EMG_GAIN_LEVEL_MIN || level > EMG_GAIN_LEVEL_MAX) {
+        return false;
+    }
+    if (level == m_gain_level) {
+        return true;
+    }
+    uint8_t wiper = (uint8_t)((level - EMG_GAIN_LEVEL_MIN) * EMG_GAIN_WIPER_STEP);
+    if (m_platform->gain_write == NULL || !m_platform->gain_write(wiper)) {
+        return false;
+    }
+    m_gain_level = level;
+    EMG_LOG_INFO("Gain level changed to %d (wiper: 0x%02X)", level, wiper);
+    return true;
+}
@@ -0,0 +1,86 @@
+#ifndef EMG_CORE_H__
+#define EMG_CORE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "emg_activation.h"
+#include "emg_stats.h"
+#include "emg_spectral.h"
+#include "emg_welch.h"
+#include "emg_classifier.h"
+#include "emg_cross.h"
+#include "emg_config.h"
+
+// Núcleo portável da cadeia de sinal: tabela de estágios do pipeline, stream
+// filtrado decimado e mapeamento do ganho. Não usa SoftDevice nem nrfx: o
+// barramento do potenciômetro e as saídas de baixa taxa passam pelos callbacks
+// de emg_core_platform_t (main.c no alvo, host/emg_host.c no PC); ciclos e log
+// vêm de emg_platform.h. Chamadas do lado DSP e do lado rádio são serializadas
+// pelo chamador (emg_sched_lock() no alvo).
+#ifndef EMG_PIPELINE_NOTCH
+#define EMG_PIPELINE_NOTCH            0       // Variantes de produto: -DEMG_PIPELINE_NOTCH=1
+#endif
+
+#define EMG_GAIN_LEVEL_MIN            1
+#define EMG_GAIN_LEVEL_MAX            10
+#define EMG_GAIN_WIPER_STEP           0x0D    // ~1 kΩ do DS3502 por nível
+
+typedef struct {
+    // Barramento: escreve o wiper do DS3502. false = escrita falhou
+    bool (*gain_write)(uint8_t wiper);
+
+    // Rádio: saídas do pipeline (chamadas no contexto do DSP)
+    void (*activation)(emg_activation_evt_t const * p_evt);
+    void (*stats)(emg_stats_snapshot_t const * p_snapshot);
+    void (*fatigue)(emg_fatigue_metrics_t const * p_metrics);
+    void (*psd)(emg_welch_snapshot_t const * p_snapshot, uint16_t len);
+#if EMG_CHANNEL_COUNT > 1
+    void (*cross)(emg_cross_snapshot_t const * p_snapshot, uint16_t len);
+#endif
+    void (*class_changed)(uint8_t class_id);
+    void (*classifier_status)(emg_classifier_status_t const * p_status);   // A cada 40 inferências
+
+    // MNF/MDF só é calculado com alguém inscrito
+    bool (*fatigue_subscribed)(void);
+} emg_core_platform_t;
+
+// Inicializa os módulos de DSP e registra a tabela de estágios. A interface
+// deve permanecer válida.
+bool emg_core_init(emg_core_platform_t const * p_platform);
+
+// Executa o pipeline sobre um bloco do ADC (in-place). first_index = índice
+// absoluto da primeira amostra, base dos eventos e da média evocada.
+uint16_t emg_core_process_block(int16_t * p_block, uint16_t n, uint32_t first_index);
+
+#if EMG_CHANNEL_COUNT > 1
+// Análise entre canais sobre os frames do mesmo bloco (uma amostra por canal,
+// sem filtro: emg_cross.c remove o offset). Chamado no contexto do DSP.
+void emg_core_process_frames(int16_t const (*p_frames)[EMG_CHANNEL_COUNT], uint16_t n);
+#endif
+
+// Próxima amostra do stream filtrado, decimada na taxa selecionada. p_index
+// (opcional) recebe o índice da amostra de entrada que completou a saída.
+// false = store vazio.
+bool emg_core_stream_pop(int16_t * p_out, uint32_t * p_index);
+
+// Transição da taxa adaptativa decidida no pipeline desde a última chamada
+bool emg_core_take_rate_switch(uint32_t * p_sample_index);
+
+bool emg_core_full_rate(void);
+
+// Modo captura por trigger e fontes aceitas (EMG_CAPTURE_SRC_*)
+void emg_core_set_capture(bool enabled, uint8_t triggers);
+
+bool emg_core_capture_mode(void);
+
+// Dispara a captura se o modo estiver ligado e a fonte estiver habilitada
+void emg_core_capture_trigger(uint8_t source);
+
+// Novo modelo: a próxima decisão do classificador é notificada mesmo se repetir
+void emg_core_class_reset(void);
+
+// Aplica o nível de ganho (EMG_GAIN_LEVEL_MIN..MAX) pelo barramento. Repetir o
+// nível atual não gera escrita. Retorna false para nível inválido ou falha.
+bool emg_core_set_gain(uint8_t level);
+
+#endif // EMG_CORE_H__
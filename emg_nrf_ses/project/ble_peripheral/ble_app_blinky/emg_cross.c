@@ -0,0 +1,201 @@
+#include "emg_cross.h"
+#include "emg_config.h"
+
+// Só as variantes multi-site pagam a RAM dos buffers por canal
+#if EMG_CHANNEL_COUNT > 1
+
+#include "emg_fft.h"
+#include "emg_prefilter.h"
+#include "emg_bandpass.h"
+#include <math.h>
+#include <string.h>
+
+#define PI_F            3.14159265358979f
+#define MAX_BINS        ((60 * EMG_CROSS_FFT_LEN) / EMG_SAMPLE_RATE_HZ + 2)
+
+static const uint8_t m_band_hz[EMG_CROSS_BAND_COUNT + 1] = { 8, 15, 30, 60 };
+
+static emg_rfft_t m_fft;
+static float      m_window[EMG_CROSS_FFT_LEN];                    // Hann pré-calculada
+static float      m_work[EMG_CROSS_FFT_LEN];
+static int16_t    m_frame[EMG_CHANNEL_COUNT][EMG_CROSS_FFT_LEN];  // Filtrado, mais antiga primeiro
+static emg_offset_t      m_offset[EMG_CHANNEL_COUNT];
+static emg_notch_t       m_notch[EMG_CHANNEL_COUNT];
+static emg_butterworth_t m_bandpass[EMG_CHANNEL_COUNT];
+static uint16_t   m_fill;
+
+// Espectros só nos bins das bandas (índice b = k - m_bin_first)
+static uint16_t   m_band_bin[EMG_CROSS_BAND_COUNT + 1];
+static uint16_t   m_bin_first;
+static uint16_t   m_n_bins;
+static float      m_x_re[EMG_CHANNEL_COUNT][MAX_BINS];            // FFT da janela atual
+static float      m_x_im[EMG_CHANNEL_COUNT][MAX_BINS];
+static float      m_sxx[EMG_CHANNEL_COUNT][MAX_BINS];             // Auto-espectros suavizados
+static float      m_sxy_re[EMG_CROSS_MAX_PAIRS][MAX_BINS];        // Espectros cruzados suavizados
+static float      m_sxy_im[EMG_CROSS_MAX_PAIRS][MAX_BINS];
+
+static uint8_t    m_pairs[EMG_CROSS_MAX_PAIRS][2];
+static uint8_t    m_n_pairs;
+static uint16_t   m_windows;                                      // Janelas na média
+static uint16_t   m_window_seq;
+
+static uint16_t hz_to_bin(uint16_t hz)
+{
+    return (uint16_t)((hz * EMG_CROSS_FFT_LEN + EMG_SAMPLE_RATE_HZ - 1) / EMG_SAMPLE_RATE_HZ);
+}
+
+void emg_cross_init(void)
+{
+    for (uint16_t i = 0; i < EMG_CROSS_FFT_LEN; i++) {
+        m_window[i] = 0.5f - 0.5f * cosf(2.0f * PI_F * (float)i / (float)EMG_CROSS_FFT_LEN);
+    }
+    for (uint8_t b = 0; b <= EMG_CROSS_BAND_COUNT; b++) {
+        m_band_bin[b] = hz_to_bin(m_band_hz[b]);
+    }
+    m_bin_first = m_band_bin[0];
+    m_n_bins    = m_band_bin[EMG_CROSS_BAND_COUNT] - m_bin_first;
+    emg_rfft_init(&m_fft, EMG_CROSS_FFT_LEN);
+
+    memset(m_offset, 0, sizeof(m_offset));
+    memset(m_notch, 0, sizeof(m_notch));
+    memset(m_bandpass, 0, sizeof(m_bandpass));
+    m_fill = 0;
+    m_window_seq = 0;
+
+    uint8_t pairs[EMG_CROSS_MAX_PAIRS][2];
+    uint8_t n = 0;
+    for (uint8_t ch = 0; ch + 1 < EMG_CHANNEL_COUNT && n < EMG_CROSS_MAX_PAIRS; ch += 2) {
+        pairs[n][0] = ch;
+        pairs[n][1] = ch + 1;
+        n++;
+    }
+    (void)emg_cross_configure((uint8_t const (*)[2])pairs, n);
+}
+
+bool emg_cross_configure(uint8_t const (*p_pairs)[2], uint8_t n_pairs)
+{
+    if (n_pairs > EMG_CROSS_MAX_PAIRS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < n_pairs; i++) {
+        if (p_pairs[i][0] >= EMG_CHANNEL_COUNT || p_pairs[i][1] >= EMG_CHANNEL_COUNT ||
+            p_pairs[i][0] == p_pairs[i][1]) {
+            return false;
+        }
+    }
+
+    memcpy(m_pairs, p_pairs, n_pairs * sizeof(m_pairs[0]));
+    m_n_pairs = n_pairs;
+    m_windows = 0;
+    return true;
+}
+
+// Falconer-Winter: 2 * área comum / soma das áreas, sinais retificados
+static uint16_t cci_permille(int16_t const * p_a, int16_t const * p_b)
+{
+    uint32_t common = 0;
+    uint32_t total  = 0;
+    for (uint16_t i = 0; i < EMG_CROSS_FFT_LEN; i++) {
+        uint16_t a = (uint16_t)(p_a[i] < 0 ? -(int32_t)p_a[i] : p_a[i]);
+        uint16_t b = (uint16_t)(p_b[i] < 0 ? -(int32_t)p_b[i] : p_b[i]);
+        common += (a < b) ? a : b;
+        total  += (uint32_t)a + b;
+    }
+    return (total == 0) ? 0 : (uint16_t)((2000ull * common) / total);
+}
+
+static void process_window(emg_cross_snapshot_t * p_snap)
+{
+    // Média exata nas primeiras janelas, exponencial depois
+    if (m_windows < EMG_CROSS_AVG_WINDOWS) {
+        m_windows++;
+    }
+    float alpha = 1.0f / (float)m_windows;
+
+    // Uma FFT por canal; os pares só combinam os bins já calculados
+    for (uint8_t ch = 0; ch < EMG_CHANNEL_COUNT; ch++) {
+        for (uint16_t i = 0; i < EMG_CROSS_FFT_LEN; i++) {
+            m_work[i] = (float)m_frame[ch][i] * m_window[i];
+        }
+        emg_rfft(&m_fft, m_work);
+
+        for (uint16_t b = 0; b < m_n_bins; b++) {
+            uint16_t k  = m_bin_first + b;
+            float    re = m_work[2 * k];
+            float    im = m_work[2 * k + 1];
+            m_x_re[ch][b] = re;
+            m_x_im[ch][b] = im;
+            m_sxx[ch][b] += alpha * (re * re + im * im - m_sxx[ch][b]);
+        }
+    }
+
+    p_snap->window_seq = m_window_seq++;
+    p_snap->n_pairs    = m_n_pairs;
+
+    for (uint8_t p = 0; p < m_n_pairs; p++) {
+        uint8_t a = m_pairs[p][0];
+        uint8_t c = m_pairs[p][1];
+        emg_cross_pair_t * p_out = &p_snap->pairs[p];
+
+        // Sxy = X * conj(Y)
+        for (uint16_t b = 0; b < m_n_bins; b++) {
+            float re = m_x_re[a][b] * m_x_re[c][b] + m_x_im[a][b] * m_x_im[c][b];
+            float im = m_x_im[a][b] * m_x_re[c][b] - m_x_re[a][b] * m_x_im[c][b];
+            m_sxy_re[p][b] += alpha * (re - m_sxy_re[p][b]);
+            m_sxy_im[p][b] += alpha * (im - m_sxy_im[p][b]);
+        }
+
+        for (uint8_t band = 0; band < EMG_CROSS_BAND_COUNT; band++) {
+            float    sum = 0.0f;
+            uint16_t b0  = m_band_bin[band] - m_bin_first;
+            uint16_t b1  = m_band_bin[band + 1] - m_bin_first;
+            for (uint16_t b = b0; b < b1; b++) {
+                float den = m_sxx[a][b] * m_sxx[c][b];
+                if (den > 0.0f) {
+                    sum += (m_sxy_re[p][b] * m_sxy_re[p][b] + m_sxy_im[p][b] * m_sxy_im[p][b]) / den;
+                }
+            }
+            float msc = (b1 > b0) ? sum / (float)(b1 - b0) : 0.0f;
+            p_out->msc_permille[band] = (uint16_t)(fminf(msc, 1.0f) * 1000.0f + 0.5f);
+        }
+
+        p_out->agonist      = a;
+        p_out->antagonist   = c;
+        p_out->cci_permille = cci_permille(m_frame[a], m_frame[c]);
+    }
+}
+
+bool emg_cross_push(int16_t const * p_frame, emg_cross_snapshot_t * p_snap, uint16_t * p_len)
+{
+    // Mesma cadeia do canal primário (o notch aqui é sempre aplicado)
+    for (uint8_t ch = 0; ch < EMG_CHANNEL_COUNT; ch++) {
+        float y = emg_offset_step(&m_offset[ch], (float)p_frame[ch]);
+        y = emg_notch_step(&m_notch[ch], y);
+        y = emg_butterworth_step(&m_bandpass[ch], y);
+        if (y > INT16_MAX) y = INT16_MAX;
+        if (y < INT16_MIN) y = INT16_MIN;
+        m_frame[ch][m_fill] = (int16_t)y;
+    }
+    if (++m_fill < EMG_CROSS_FFT_LEN) {
+        return false;
+    }
+
+    if (m_windows == 0) {
+        // Pares mudaram: espectros cruzados recomeçam junto com os auto-espectros
+        memset(m_sxx, 0, sizeof(m_sxx));
+        memset(m_sxy_re, 0, sizeof(m_sxy_re));
+        memset(m_sxy_im, 0, sizeof(m_sxy_im));
+    }
+    process_window(p_snap);
+
+    // 50% de sobreposição: a segunda metade vira o início da próxima janela
+    for (uint8_t ch = 0; ch < EMG_CHANNEL_COUNT; ch++) {
+        memmove(m_frame[ch], &m_frame[ch][EMG_CROSS_HOP], EMG_CROSS_HOP * sizeof(int16_t));
+    }
+    m_fill = EMG_CROSS_FFT_LEN - EMG_CROSS_HOP;
+
+    *p_len = (uint16_t)(EMG_CROSS_HEADER_LEN + m_n_pairs * sizeof(emg_cross_pair_t));
+    return m_windows >= EMG_CROSS_AVG_WINDOWS && m_n_pairs > 0;
+}
+
+#endif // EMG_CHANNEL_COUNT > 1
@@ -0,0 +1,56 @@
+#ifndef EMG_CROSS_H__
+#define EMG_CROSS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Análise entre canais para EMG multi-site, por par agonista/antagonista:
+//  - Índice de co-contração (Falconer-Winter) sobre o sinal retificado da janela
+//  - Coerência quadrática (MSC) média por banda, com espectros cruzados
+//    suavizados entre janelas (|Sxy|² / (Sxx * Syy))
+// Custo limitado: uma FFT por canal por janela, reaproveitada por todos os pares.
+// Cada canal passa pelo condicionamento do pipeline (offset, notch da rede,
+// passa-banda IIR) antes da janela: a rede em modo comum cairia na banda gama
+// e dominaria a coerência, e artefato de movimento distorceria o CCI.
+// Janela Hann de 512 pontos, 50% de sobreposição: @1kSPS → ~2 Hz e 4 resultados/s
+#define EMG_CROSS_FFT_LEN             512
+#define EMG_CROSS_HOP                 (EMG_CROSS_FFT_LEN / 2)
+#define EMG_CROSS_MAX_PAIRS           4
+#define EMG_CROSS_AVG_WINDOWS         8       // Constante da média exponencial dos espectros (~2 s)
+
+// Bandas de coerência intermuscular (Hz, [baixo, alto))
+typedef enum {
+    EMG_CROSS_BAND_ALPHA = 0,         // 8-15 Hz
+    EMG_CROSS_BAND_BETA,              // 15-30 Hz
+    EMG_CROSS_BAND_GAMMA,             // 30-60 Hz
+    EMG_CROSS_BAND_COUNT
+} emg_cross_band_t;
+
+typedef struct __attribute__((packed)) {
+    uint8_t  agonist;                 // Índice do canal
+    uint8_t  antagonist;
+    uint16_t cci_permille;            // Co-contração, 0..1000
+    uint16_t msc_permille[EMG_CROSS_BAND_COUNT];  // Coerência média na banda, 0..1000
+} emg_cross_pair_t;
+
+// Payload da característica (3 + 10 * n_pairs bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint16_t         window_seq;
+    uint8_t          n_pairs;
+    emg_cross_pair_t pairs[EMG_CROSS_MAX_PAIRS];
+} emg_cross_snapshot_t;
+
+#define EMG_CROSS_HEADER_LEN          3
+
+// Pares padrão: (0,1), (2,3)... conforme EMG_CHANNEL_COUNT.
+void emg_cross_init(void);
+
+// Define os pares agonista/antagonista (canais < EMG_CHANNEL_COUNT, distintos).
+// Reinicia as médias. Retorna false se algum par for inválido.
+bool emg_cross_configure(uint8_t const (*p_pairs)[2], uint8_t n_pairs);
+
+// Acumula um frame (uma amostra por canal). Retorna true quando uma janela foi
+// processada e p_snap contém o resultado (após EMG_CROSS_AVG_WINDOWS janelas).
+bool emg_cross_push(int16_t const * p_frame, emg_cross_snapshot_t * p_snap, uint16_t * p_len);
+
+#endif // EMG_CROSS_H__
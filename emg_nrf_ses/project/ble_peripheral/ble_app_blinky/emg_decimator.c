@@ -0,0 +1,168 @@
+#include "emg_decimator.h"
+#include "emg_config.h"
+#include <string.h>
+
+// Coeficientes gerados offline (windowed-sinc, Hamming), normalizados para
+// ganho DC = L. O protótipo roda a L * EMG_SAMPLE_RATE_HZ; a fase p usa
+// h[p], h[p + L], h[p + 2L], ...
+
+// 500 Hz: L=1, M=2, 24 taps (24 por fase)
+static const float m_h_500[24] = {
+    -1.156373343e-03f, 2.236189436e-03f, 3.742508375e-03f, -4.420226684e-03f, -1.286881294e-02f, 5.100665721e-03f,
+    3.294966962e-02f, 3.849807383e-03f, -7.117498834e-02f, -4.367463094e-02f, 1.739534477e-01f, 4.114627440e-01f,
+    4.114627440e-01f, 1.739534477e-01f, -4.367463094e-02f, -7.117498834e-02f, 3.849807383e-03f, 3.294966962e-02f,
+    5.100665721e-03f, -1.286881294e-02f, -4.420226684e-03f, 3.742508375e-03f, 2.236189436e-03f, -1.156373343e-03f,
+};
+
+// 400 Hz: L=2, M=5, 48 taps (24 por fase)
+static const float m_h_400[48] = {
+    1.434845157e-03f, 3.726876544e-04f, -1.134268520e-03f, -2.995714377e-03f, -4.711279743e-03f, -5.307771076e-03f,
+    -3.641038531e-03f, 9.710804313e-04f, 8.037817639e-03f, 1.549511903e-02f, 1.996674009e-02f, 1.780901234e-02f,
+    6.714344651e-03f, -1.267629386e-02f, -3.585057952e-02f, -5.476499392e-02f, -5.962887853e-02f, -4.177688077e-02f,
+    3.207355487e-03f, 7.318047299e-02f, 1.588598175e-01f, 2.453915774e-01f, 3.157833215e-01f, 3.552635070e-01f,
+    3.552635070e-01f, 3.157833215e-01f, 2.453915774e-01f, 1.588598175e-01f, 7.318047299e-02f, 3.207355487e-03f,
+    -4.177688077e-02f, -5.962887853e-02f, -5.476499392e-02f, -3.585057952e-02f, -1.267629386e-02f, 6.714344651e-03f,
+    1.780901234e-02f, 1.996674009e-02f, 1.549511903e-02f, 8.037817639e-03f, 9.710804313e-04f, -3.641038531e-03f,
+    -5.307771076e-03f, -4.711279743e-03f, -2.995714377e-03f, -1.134268520e-03f, 3.726876544e-04f, 1.434845157e-03f,
+};
+
+// 250 Hz: L=1, M=4, 32 taps (32 por fase)
+static const float m_h_250[32] = {
+    -1.644461675e-03f, -1.443894963e-03f, -3.255850716e-04f, 2.302215273e-03f, 5.952980309e-03f, 8.181796503e-03f,
+    5.343125061e-03f, -4.789287991e-03f, -1.991242834e-02f, -3.192320818e-02f, -2.922295016e-02f, -2.285493961e-03f,
+    5.014235603e-02f, 1.178629199e-01f, 1.815568921e-01f, 2.202050251e-01f, 2.202050251e-01f, 1.815568921e-01f,
+    1.178629199e-01f, 5.014235603e-02f, -2.285493961e-03f, -2.922295016e-02f, -3.192320818e-02f, -1.991242834e-02f,
+    -4.789287991e-03f, 5.343125061e-03f, 8.181796503e-03f, 5.952980309e-03f, 2.302215273e-03f, -3.255850716e-04f,
+    -1.443894963e-03f, -1.644461675e-03f,
+};
+
+// 100 Hz: L=1, M=10, 64 taps (64 por fase)
+static const float m_h_100[64] = {
+    3.996998830e-04f, 6.154223621e-04f, 8.480874198e-04f, 1.096163732e-03f, 1.337162420e-03f, 1.525161097e-03f,
+    1.593148000e-03f, 1.460543478e-03f, 1.045459186e-03f, 2.804545773e-04f, -8.701397296e-04f, -2.393735909e-03f,
+    -4.216420420e-03f, -6.195715904e-03f, -8.121074042e-03f, -9.723187002e-03f, -1.069217824e-02f, -1.070361205e-02f,
+    -9.450183179e-03f, -6.676053176e-03f, -2.210210783e-03f, 4.004958068e-03f, 1.189345605e-02f, 2.123669776e-02f,
+    3.167759591e-02f, 4.273821488e-02f, 5.385005563e-02f, 6.439463880e-02f, 7.375086190e-02f, 8.134476467e-02f,
+    8.669694862e-02f, 8.946301598e-02f, 8.946301598e-02f, 8.669694862e-02f, 8.134476467e-02f, 7.375086190e-02f,
+    6.439463880e-02f, 5.385005563e-02f, 4.273821488e-02f, 3.167759591e-02f, 2.123669776e-02f, 1.189345605e-02f,
+    4.004958068e-03f, -2.210210783e-03f, -6.676053176e-03f, -9.450183179e-03f, -1.070361205e-02f, -1.069217824e-02f,
+    -9.723187002e-03f, -8.121074042e-03f, -6.195715904e-03f, -4.216420420e-03f, -2.393735909e-03f, -8.701397296e-04f,
+    2.804545773e-04f, 1.045459186e-03f, 1.460543478e-03f, 1.593148000e-03f, 1.525161097e-03f, 1.337162420e-03f,
+    1.096163732e-03f, 8.480874198e-04f, 6.154223621e-04f, 3.996998830e-04f,
+};
+
+// 50 Hz: L=1, M=20, 128 taps (128 por fase)
+static const float m_h_50[128] = {
+    1.732587214e-04f, 2.275163072e-04f, 2.834813320e-04f, 3.419094011e-04f, 4.031269077e-04f, 4.669138162e-04f,
+    5.324084300e-04f, 5.980401028e-04f, 6.614949815e-04f, 7.197187666e-04f, 7.689591827e-04f, 8.048494046e-04f,
+    8.225321279e-04f, 8.168223687e-04f, 7.824054693e-04f, 7.140652406e-04f, 6.069357399e-04f, 4.567689217e-04f,
+    2.602093560e-04f, 1.506642703e-05f, -2.794260542e-04f, -6.223730476e-04f, -1.011014329e-03f, -1.440562889e-03f,
+    -1.904094310e-03f, -2.392494553e-03f, -2.894472093e-03f, -3.396638566e-03f, -3.883660162e-03f, -4.338479861e-03f,
+    -4.742608403e-03f, -5.076479671e-03f, -5.319863986e-03f, -5.452330718e-03f, -5.453749806e-03f, -5.304820069e-03f,
+    -4.987610948e-03f, -4.486103304e-03f, -3.786714331e-03f, -2.878791534e-03f, -1.755060953e-03f, -4.120156095e-04f,
+    1.149768737e-03f, 2.925401835e-03f, 4.905540580e-03f, 7.076351178e-03f, 9.419576447e-03f, 1.191271018e-02f,
+    1.452927762e-02f, 1.723921835e-02f, 2.000936490e-02f, 2.280400789e-02f, 2.558553593e-02f, 2.831513628e-02f,
+    3.095354052e-02f, 3.346179793e-02f, 3.580205835e-02f, 3.793834574e-02f, 3.983730360e-02f, 4.146889415e-02f,
+    4.280703371e-02f, 4.383014869e-02f, 4.452163817e-02f, 4.487023142e-02f, 4.487023142e-02f, 4.452163817e-02f,
+    4.383014869e-02f, 4.280703371e-02f, 4.146889415e-02f, 3.983730360e-02f, 3.793834574e-02f, 3.580205835e-02f,
+    3.346179793e-02f, 3.095354052e-02f, 2.831513628e-02f, 2.558553593e-02f, 2.280400789e-02f, 2.000936490e-02f,
+    1.723921835e-02f, 1.452927762e-02f, 1.191271018e-02f, 9.419576447e-03f, 7.076351178e-03f, 4.905540580e-03f,
+    2.925401835e-03f, 1.149768737e-03f, -4.120156095e-04f, -1.755060953e-03f, -2.878791534e-03f, -3.786714331e-03f,
+    -4.486103304e-03f, -4.987610948e-03f, -5.304820069e-03f, -5.453749806e-03f, -5.452330718e-03f, -5.319863986e-03f,
+    -5.076479671e-03f, -4.742608403e-03f, -4.338479861e-03f, -3.883660162e-03f, -3.396638566e-03f, -2.894472093e-03f,
+    -2.392494553e-03f, -1.904094310e-03f, -1.440562889e-03f, -1.011014329e-03f, -6.223730476e-04f, -2.794260542e-04f,
+    1.506642703e-05f, 2.602093560e-04f, 4.567689217e-04f, 6.069357399e-04f, 7.140652406e-04f, 7.824054693e-04f,
+    8.168223687e-04f, 8.225321279e-04f, 8.048494046e-04f, 7.689591827e-04f, 7.197187666e-04f, 6.614949815e-04f,
+    5.980401028e-04f, 5.324084300e-04f, 4.669138162e-04f, 4.031269077e-04f, 3.419094011e-04f, 2.834813320e-04f,
+    2.275163072e-04f, 1.732587214e-04f,
+};
+
+typedef struct {
+    uint16_t      rate_hz;
+    uint8_t       l;              // Interpolação
+    uint8_t       m;              // Decimação
+    uint16_t      taps_per_phase;
+    float const * p_h;            // NULL = bypass
+} decim_profile_t;
+
+static const decim_profile_t m_profiles[] = {
+    { EMG_SAMPLE_RATE_HZ, 1, 1,  0,   NULL    },
+    { 500,                1, 2,  24,  m_h_500 },
+    { 400,                2, 5,  24,  m_h_400 },
+    { 250,                1, 4,  32,  m_h_250 },
+    { 100,                1, 10, 64,  m_h_100 },
+    { 50,                 1, 20, 128, m_h_50  },
+};
+
+#define PROFILE_COUNT   (sizeof(m_profiles) / sizeof(m_profiles[0]))
+#define MAX_TAPS        128
+
+static decim_profile_t const * mp_profile = &m_profiles[0];
+static int16_t  m_hist[2 * MAX_TAPS];   // Linha de atraso duplicada: leitura contígua sem wrap
+static uint16_t m_pos;
+static uint16_t m_phase;
+
+static void reset_state(void)
+{
+    memset(m_hist, 0, sizeof(m_hist));
+    m_pos = 0;
+    m_phase = 0;
+}
+
+void emg_decimator_init(void)
+{
+    mp_profile = &m_profiles[0];
+    reset_state();
+}
+
+bool emg_decimator_select(uint16_t out_rate_hz)
+{
+    for (uint8_t i = 0; i < PROFILE_COUNT; i++) {
+        if (m_profiles[i].rate_hz == out_rate_hz) {
+            mp_profile = &m_profiles[i];
+            reset_state();
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t emg_decimator_rate_hz(void)
+{
+    return mp_profile->rate_hz;
+}
+
+uint8_t emg_decimator_process(int16_t sample, int16_t * p_out)
+{
+    decim_profile_t const * p = mp_profile;
+
+    if (p->p_h == NULL) {
+        p_out[0] = sample;
+        return 1;
+    }
+
+    // Amostra mais nova em m_hist[m_pos], mais antigas em m_pos + 1, m_pos + 2, ...
+    uint16_t k_taps = p->taps_per_phase;
+    m_pos = (m_pos == 0) ? (uint16_t)(k_taps - 1) : (uint16_t)(m_pos - 1);
+    m_hist[m_pos]          = sample;
+    m_hist[m_pos + k_taps] = sample;
+
+    uint8_t count = 0;
+    while (m_phase < p->l) {
+        float const   * p_h = &p->p_h[m_phase];
+        int16_t const * p_x = &m_hist[m_pos];
+        float acc = 0.0f;
+        for (uint16_t k = 0; k < k_taps; k++) {
+            acc += p_h[k * p->l] * (float)p_x[k];
+        }
+        if (acc > 32767.0f)  acc = 32767.0f;
+        if (acc < -32768.0f) acc = -32768.0f;
+        if (count < EMG_DECIM_MAX_OUT) {
+            p_out[count++] = (int16_t)acc;
+        }
+        m_phase += p->m;
+    }
+    m_phase -= p->l;
+
+    return count;
+}
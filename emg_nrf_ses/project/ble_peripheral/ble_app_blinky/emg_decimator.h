@@ -0,0 +1,32 @@
+#ifndef EMG_DECIMATOR_H__
+#define EMG_DECIMATOR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Reamostragem polifásica L/M entre butterworth_filter() e o empacotamento.
+// Cada taxa de saída tem seu filtro anti-aliasing pré-calculado
+// (janela de Hamming, corte em 0.45 * fs_out). A taxa cheia é bypass.
+//
+//   Saída    L/M     taps   MACs/amostra de entrada
+//   1000 Hz  1/1     -      0
+//    500 Hz  1/2     24     12
+//    400 Hz  2/5     48     9.6
+//    250 Hz  1/4     32     8
+//    100 Hz  1/10    64     6.4
+//     50 Hz  1/20    128    6.4
+#define EMG_DECIM_MAX_OUT             1       // Saídas por amostra de entrada (L <= M em todas as taxas)
+
+void emg_decimator_init(void);
+
+// Seleciona a taxa de saída em Hz. Retorna false se a taxa não é suportada
+// (a seleção atual é mantida). Zera o histórico do filtro.
+bool emg_decimator_select(uint16_t out_rate_hz);
+
+uint16_t emg_decimator_rate_hz(void);
+
+// Processa uma amostra na taxa do ADC. Retorna o número de amostras
+// escritas em p_out (0..EMG_DECIM_MAX_OUT).
+uint8_t emg_decimator_process(int16_t sample, int16_t * p_out);
+
+#endif // EMG_DECIMATOR_H__
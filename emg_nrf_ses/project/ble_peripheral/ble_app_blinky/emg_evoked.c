@@ -0,0 +1,175 @@
+#include "emg_evoked.h"
+#include "emg_config.h"
+#include <string.h>
+
+#define HISTORY_MASK    (EMG_EVOKED_HISTORY - 1)
+
+static int32_t  m_acc[EMG_EVOKED_MAX_SAMPLES];     // Soma das épocas da média atual
+static int16_t  m_avg[EMG_EVOKED_MAX_SAMPLES];     // Última média completa (enviada em chunks)
+static int16_t  m_history[EMG_EVOKED_HISTORY];
+static uint32_t m_next_index;                      // Índice esperado da próxima amostra
+static uint16_t m_filled;                          // Histórico válido desde a configuração
+static uint16_t m_trials;                          // N (0 = desligado)
+static uint16_t m_window;                          // Amostras por época
+static bool     m_in_epoch;
+static uint32_t m_epoch_start;
+static uint16_t m_epoch_pos;
+static uint16_t m_trials_done;
+static uint16_t m_rejected;
+static bool     m_pending;                         // Média pronta aguardando envio
+static uint16_t m_pending_rejected;
+static uint8_t  m_chunk_index;
+static uint8_t  m_chunk_count;
+static uint16_t m_average_seq;
+
+static uint16_t ms_to_samples(uint16_t ms)
+{
+    return (uint16_t)(((uint32_t)ms * EMG_SAMPLE_RATE_HZ) / 1000u);
+}
+
+static void restart(void)
+{
+    memset(m_acc, 0, sizeof(m_acc));
+    m_filled      = 0;
+    m_in_epoch    = false;
+    m_trials_done = 0;
+    m_rejected    = 0;
+    m_pending     = false;
+}
+
+void emg_evoked_init(void)
+{
+    m_average_seq = 0;
+    m_next_index  = 0;
+    (void)emg_evoked_configure(0, EMG_EVOKED_DEFAULT_WINDOW_MS);
+}
+
+bool emg_evoked_configure(uint16_t trials, uint16_t window_ms)
+{
+    uint16_t window = ms_to_samples(window_ms);
+
+    if (trials > EMG_EVOKED_MAX_TRIALS || window == 0 ||
+        window_ms > EMG_EVOKED_MAX_WINDOW_MS || window > EMG_EVOKED_MAX_SAMPLES) {
+        return false;
+    }
+
+    m_trials = trials;
+    m_window = window;
+    restart();
+    return true;
+}
+
+bool emg_evoked_enabled(void)
+{
+    return m_trials != 0;
+}
+
+static void accumulate(int16_t sample)
+{
+    m_acc[m_epoch_pos++] += sample;
+    if (m_epoch_pos < m_window) {
+        return;
+    }
+
+    m_in_epoch = false;
+    if (++m_trials_done < m_trials) {
+        return;
+    }
+
+    // Média com arredondamento simétrico; a soma recomeça para a próxima
+    int32_t half = m_trials / 2;
+    for (uint16_t i = 0; i < m_window; i++) {
+        int32_t acc = m_acc[i];
+        m_avg[i] = (int16_t)((acc >= 0 ? acc + half : acc - half) / m_trials);
+    }
+    memset(m_acc, 0, sizeof(m_acc));
+    m_pending_rejected = m_rejected;
+    m_trials_done = 0;
+    m_rejected    = 0;
+    m_chunk_index = 0;
+    m_chunk_count = (uint8_t)((m_window + EMG_EVOKED_CHUNK_SAMPLES - 1) / EMG_EVOKED_CHUNK_SAMPLES);
+    m_pending     = true;
+}
+
+void emg_evoked_push(uint32_t index, int16_t sample)
+{
+    m_history[index & HISTORY_MASK] = sample;
+    m_next_index = index + 1;
+    if (m_filled < EMG_EVOKED_HISTORY) {
+        m_filled++;
+    }
+
+    if (m_in_epoch && (int32_t)(index - m_epoch_start) >= 0) {
+        accumulate(sample);
+    }
+}
+
+uint16_t emg_evoked_trigger(uint32_t index)
+{
+    if (m_trials == 0) {
+        return 0;
+    }
+
+    // Só um trigger por vez: épocas sobrepostas misturariam respostas
+    int32_t ago = (int32_t)(m_next_index - index);
+    if (m_in_epoch || m_pending || ago > (int32_t)m_filled) {
+        if (m_rejected < UINT16_MAX) {
+            m_rejected++;
+        }
+        return 0;
+    }
+
+    uint16_t trial = (uint16_t)(m_trials_done + 1);
+    m_in_epoch    = true;
+    m_epoch_start = index;
+    m_epoch_pos   = 0;
+
+    // Amostras já processadas depois da borda saem do histórico
+    for (int32_t i = ago; i > 0 && m_in_epoch; i--) {
+        accumulate(m_history[(m_next_index - (uint32_t)i) & HISTORY_MASK]);
+    }
+    return trial;
+}
+
+bool emg_evoked_peek_chunk(emg_evoked_chunk_t * p_chunk, uint16_t * p_len)
+{
+    if (!m_pending) {
+        return false;
+    }
+
+    uint16_t offset = (uint16_t)m_chunk_index * EMG_EVOKED_CHUNK_SAMPLES;
+    uint16_t n      = m_window - offset;
+    if (n > EMG_EVOKED_CHUNK_SAMPLES) {
+        n = EMG_EVOKED_CHUNK_SAMPLES;
+    }
+
+    memcpy(p_chunk->samples, &m_avg[offset], n * sizeof(int16_t));
+    p_chunk->average_seq = m_average_seq;
+    p_chunk->chunk_index = m_chunk_index;
+    p_chunk->chunk_count = m_chunk_count;
+    p_chunk->n_samples   = (uint8_t)n;
+    p_chunk->trials      = m_trials;
+    p_chunk->rejected    = m_pending_rejected;
+
+    *p_len = (uint16_t)(EMG_EVOKED_HEADER_LEN + n * sizeof(int16_t));
+    return true;
+}
+
+void emg_evoked_chunk_sent(void)
+{
+    if (!m_pending) {
+        return;
+    }
+    if (++m_chunk_index >= m_chunk_count) {
+        m_average_seq++;
+        m_pending = false;
+    }
+}
+
+void emg_evoked_discard(void)
+{
+    if (m_pending) {
+        m_average_seq++;
+        m_pending = false;
+    }
+}
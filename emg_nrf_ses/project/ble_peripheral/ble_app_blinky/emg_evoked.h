@@ -0,0 +1,62 @@
+#ifndef EMG_EVOKED_H__
+#define EMG_EVOKED_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Média coerente de respostas evocadas: soma N janelas pós-trigger do sinal
+// filtrado, alinhadas na amostra do trigger, e envia só a forma de onda média
+// (N vezes menos dados que as épocas individuais). Triggers que chegam durante
+// uma época ou com uma média ainda por enviar são rejeitados e contados.
+#define EMG_EVOKED_MAX_WINDOW_MS      500     // Janela pós-trigger máxima
+#define EMG_EVOKED_MAX_SAMPLES        500     // EMG_EVOKED_MAX_WINDOW_MS @ 1 kSPS
+#define EMG_EVOKED_MAX_TRIALS         1024    // Soma em int32 sem overflow
+#define EMG_EVOKED_DEFAULT_WINDOW_MS  100
+#define EMG_EVOKED_HISTORY            64      // Potência de 2: triggers resolvidos no passado
+#define EMG_EVOKED_CHUNK_SAMPLES      60
+
+// Trigger externo marcado no stream (8 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint32_t sample_index;            // Primeira amostra após a borda (mesma base dos eventos de ativação)
+    uint16_t latency_us;              // Borda → aquisição dessa amostra (0 = sem timestamp)
+    uint16_t trial;                   // Época aceita pelo averager (1..N); 0 = não usada
+} emg_trigger_evt_t;
+
+// Chunk da média (9 + 2 * n_samples bytes)
+typedef struct __attribute__((packed)) {
+    uint16_t average_seq;             // Incrementa a cada média enviada
+    uint8_t  chunk_index;
+    uint8_t  chunk_count;
+    uint8_t  n_samples;
+    uint16_t trials;                  // Épocas somadas
+    uint16_t rejected;                // Triggers descartados durante esta média
+    int16_t  samples[EMG_EVOKED_CHUNK_SAMPLES];
+} emg_evoked_chunk_t;
+
+#define EMG_EVOKED_HEADER_LEN         9
+
+void emg_evoked_init(void);
+
+// N épocas por média (0 desliga) e janela pós-trigger em ms. Descarta a
+// média em andamento. Retorna false para valores inválidos.
+bool emg_evoked_configure(uint16_t trials, uint16_t window_ms);
+
+bool emg_evoked_enabled(void);
+
+// Amostra filtrada com seu índice absoluto (índices consecutivos).
+void emg_evoked_push(uint32_t index, int16_t sample);
+
+// Inicia uma época na amostra indicada (pode estar até EMG_EVOKED_HISTORY
+// amostras no passado). Retorna o número da época (1..N) ou 0 se rejeitada.
+uint16_t emg_evoked_trigger(uint32_t index);
+
+// Próximo chunk da média pronta para envio. Retorna false se não houver média.
+bool emg_evoked_peek_chunk(emg_evoked_chunk_t * p_chunk, uint16_t * p_len);
+
+// Confirma o envio do chunk obtido em emg_evoked_peek_chunk().
+void emg_evoked_chunk_sent(void);
+
+// Descarta a média pronta (ex.: client sem inscrição).
+void emg_evoked_discard(void);
+
+#endif // EMG_EVOKED_H__
@@ -0,0 +1,80 @@
+#include "emg_features.h"
+#include <math.h>
+#include <stdlib.h>
+
+static int16_t  m_ring[EMG_FEAT_WINDOW];
+static uint16_t m_pos;                // Próxima posição de escrita (= amostra mais antiga)
+static uint16_t m_count;
+static uint16_t m_hop;
+
+void emg_features_init(void)
+{
+    m_pos = 0;
+    m_count = 0;
+    m_hop = 0;
+}
+
+static void compute(float * p_feat)
+{
+    uint32_t sum_abs = 0;
+    uint64_t sum_sq  = 0;
+    uint32_t wl      = 0;
+    uint16_t zc      = 0;
+    uint16_t ssc     = 0;
+
+    int32_t x2 = 0, x1 = 0;
+    for (uint16_t n = 0; n < EMG_FEAT_WINDOW; n++) {
+        uint16_t idx = m_pos + n;
+        if (idx >= EMG_FEAT_WINDOW) idx -= EMG_FEAT_WINDOW;
+        int32_t x = m_ring[idx];
+
+        sum_abs += (uint32_t)abs(x);
+        sum_sq  += (uint64_t)((int64_t)x * x);
+
+        if (n >= 1) {
+            wl += (uint32_t)abs(x - x1);
+            if (((x1 > 0 && x < 0) || (x1 < 0 && x > 0)) && abs(x - x1) >= EMG_FEAT_DEADBAND) {
+                zc++;
+            }
+        }
+        if (n >= 2) {
+            // Inclinação troca de sinal em x1 com amplitude acima do limiar
+            int32_t d1 = x1 - x2;
+            int32_t d2 = x1 - x;
+            if (d1 * d2 > 0 && (abs(d1) >= EMG_FEAT_DEADBAND || abs(d2) >= EMG_FEAT_DEADBAND)) {
+                ssc++;
+            }
+        }
+        x2 = x1;
+        x1 = x;
+    }
+
+    p_feat[EMG_FEAT_MAV] = (float)sum_abs / (float)EMG_FEAT_WINDOW;
+    p_feat[EMG_FEAT_RMS] = sqrtf((float)sum_sq / (float)EMG_FEAT_WINDOW);
+    p_feat[EMG_FEAT_WL]  = (float)wl;
+    p_feat[EMG_FEAT_ZC]  = (float)zc;
+    p_feat[EMG_FEAT_SSC] = (float)ssc;
+}
+
+bool emg_features_push(int16_t sample, float * p_feat)
+{
+    m_ring[m_pos++] = sample;
+    if (m_pos >= EMG_FEAT_WINDOW) {
+        m_pos = 0;
+    }
+    if (m_count < EMG_FEAT_WINDOW) {
+        m_count++;
+    }
+
+    if (++m_hop < EMG_FEAT_HOP) {
+        return false;
+    }
+    m_hop = 0;
+
+    if (m_count < EMG_FEAT_WINDOW) {
+        return false;
+    }
+
+    compute(p_feat);
+    return true;
+}
@@ -0,0 +1,29 @@
+#ifndef EMG_FEATURES_H__
+#define EMG_FEATURES_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Vetor de features no domínio do tempo (conjunto de Hudgins + RMS) sobre
+// uma janela deslizante do sinal filtrado, entrada do classificador.
+//   150 ms de janela, hop de 25 ms → 40 decisões/s @ 1kSPS
+#define EMG_FEAT_WINDOW               150
+#define EMG_FEAT_HOP                  25
+#define EMG_FEAT_DEADBAND             10      // Limiar (contagens) para ZC/SSC ignorarem ruído
+
+typedef enum {
+    EMG_FEAT_MAV = 0,                 // Média do valor absoluto
+    EMG_FEAT_RMS,
+    EMG_FEAT_WL,                      // Comprimento de onda (soma de |x[n] - x[n-1]|)
+    EMG_FEAT_ZC,                      // Cruzamentos por zero
+    EMG_FEAT_SSC,                     // Mudanças de sinal da inclinação
+    EMG_FEAT_COUNT
+} emg_feature_t;
+
+void emg_features_init(void);
+
+// Acumula uma amostra filtrada. Retorna true a cada hop (com a janela cheia)
+// e preenche p_feat[EMG_FEAT_COUNT].
+bool emg_features_push(int16_t sample, float * p_feat);
+
+#endif // EMG_FEATURES_H__
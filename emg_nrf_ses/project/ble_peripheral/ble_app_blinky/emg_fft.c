@@ -0,0 +1,107 @@
+#include "emg_fft.h"
+#include <math.h>
+
+#define PI_F 3.14159265358979f
+
+// W_N^k = exp(-j*2*pi*k/N) para N = EMG_FFT_MAX_LEN, k < N/2
+static float m_tw_cos[EMG_FFT_MAX_LEN / 2];
+static float m_tw_sin[EMG_FFT_MAX_LEN / 2];
+static bool  m_tw_ready = false;
+
+static void twiddles_init(void)
+{
+    for (uint16_t k = 0; k < EMG_FFT_MAX_LEN / 2; k++) {
+        float phase = -2.0f * PI_F * (float)k / (float)EMG_FFT_MAX_LEN;
+        m_tw_cos[k] = cosf(phase);
+        m_tw_sin[k] = sinf(phase);
+    }
+    m_tw_ready = true;
+}
+
+bool emg_rfft_init(emg_rfft_t * p_fft, uint16_t len)
+{
+    if (len < 4 || len > EMG_FFT_MAX_LEN || (len & (len - 1)) != 0) {
+        return false;
+    }
+    if (!m_tw_ready) {
+        twiddles_init();
+    }
+    p_fft->len    = len;
+    p_fft->stride = EMG_FFT_MAX_LEN / len;
+    return true;
+}
+
+// FFT complexa de m pontos sobre dados intercalados (re, im).
+// tw_step converte o índice do twiddle de tamanho m para a tabela de EMG_FFT_MAX_LEN.
+static void cfft(float * p_buf, uint16_t m, uint16_t tw_step)
+{
+    // Permutação bit-reversa
+    for (uint16_t i = 1, j = 0; i < m; i++) {
+        uint16_t bit = m >> 1;
+        for (; j & bit; bit >>= 1) {
+            j ^= bit;
+        }
+        j ^= bit;
+        if (i < j) {
+            float tr = p_buf[2 * i], ti = p_buf[2 * i + 1];
+            p_buf[2 * i]     = p_buf[2 * j];
+            p_buf[2 * i + 1] = p_buf[2 * j + 1];
+            p_buf[2 * j]     = tr;
+            p_buf[2 * j + 1] = ti;
+        }
+    }
+
+    // Borboletas radix-2
+    for (uint16_t span = 1; span < m; span <<= 1) {
+        // Twiddle exp(-j*2*pi*i/(2*span)) = W_MAX^(i * MAX/(2*span))
+        uint16_t step = (uint16_t)(tw_step * (m / (2 * span)));
+        for (uint16_t i = 0; i < span; i++) {
+            float wr = m_tw_cos[i * step];
+            float wi = m_tw_sin[i * step];
+            for (uint16_t a = i; a < m; a += 2 * span) {
+                uint16_t b = a + span;
+                float br = p_buf[2 * b] * wr - p_buf[2 * b + 1] * wi;
+                float bi = p_buf[2 * b] * wi + p_buf[2 * b + 1] * wr;
+                p_buf[2 * b]     = p_buf[2 * a] - br;
+                p_buf[2 * b + 1] = p_buf[2 * a + 1] - bi;
+                p_buf[2 * a]     += br;
+                p_buf[2 * a + 1] += bi;
+            }
+        }
+    }
+}
+
+void emg_rfft(emg_rfft_t const * p_fft, float * p_buf)
+{
+    uint16_t n = p_fft->len;
+    uint16_t m = n / 2;
+
+    // Amostras pares/ímpares como parte real/imaginária de uma FFT complexa de N/2
+    cfft(p_buf, m, (uint16_t)(2 * p_fft->stride));
+
+    // Separação do espectro real: X[k] = E[k] - j * W_N^k * O[k]
+    float z0r = p_buf[0], z0i = p_buf[1];
+    p_buf[0] = z0r + z0i;   // DC
+    p_buf[1] = z0r - z0i;   // Nyquist
+
+    for (uint16_t k = 1; k <= m / 2; k++) {
+        uint16_t km = m - k;
+        float ar = p_buf[2 * k],  ai = p_buf[2 * k + 1];
+        float br = p_buf[2 * km], bi = -p_buf[2 * km + 1];
+
+        float er = 0.5f * (ar + br), ei = 0.5f * (ai + bi);
+        float or_ = 0.5f * (ar - br), oi = 0.5f * (ai - bi);
+
+        float wr = m_tw_cos[k * p_fft->stride];
+        float wi = m_tw_sin[k * p_fft->stride];
+        float tr = wr * or_ - wi * oi;
+        float ti = wr * oi + wi * or_;
+
+        p_buf[2 * k]      = er + ti;
+        p_buf[2 * k + 1]  = ei - tr;
+        if (km != k) {
+            p_buf[2 * km]     = er - ti;
+            p_buf[2 * km + 1] = -ei - tr;
+        }
+    }
+}
@@ -0,0 +1,25 @@
+#ifndef EMG_FFT_H__
+#define EMG_FFT_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// FFT real in-place, radix-2, float32.
+// O formato de saída é o mesmo de arm_rfft_fast_f32 (CMSIS-DSP):
+//   p_buf[0] = Re{X[0]}, p_buf[1] = Re{X[N/2]},
+//   p_buf[2k] = Re{X[k]}, p_buf[2k+1] = Im{X[k]} para 1 <= k < N/2
+// A tabela de twiddles é única (calculada para EMG_FFT_MAX_LEN) e
+// compartilhada por todas as instâncias via stride.
+#define EMG_FFT_MAX_LEN               512
+
+typedef struct {
+    uint16_t len;       // Número de pontos reais (potência de 2, 4..EMG_FFT_MAX_LEN)
+    uint16_t stride;    // EMG_FFT_MAX_LEN / len
+} emg_rfft_t;
+
+bool emg_rfft_init(emg_rfft_t * p_fft, uint16_t len);
+
+// Transforma p_buf (len floats) no lugar.
+void emg_rfft(emg_rfft_t const * p_fft, float * p_buf);
+
+#endif // EMG_FFT_H__
@@ -0,0 +1,128 @@
+#include "emg_fir.h"
+#include "emg_platform.h"
+#include <string.h>
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define FIR_ROR16(x)          __ROR((x), 16)
+#define FIR_SHADD16(a, b)     __SHADD16((a), (b))
+#define FIR_SMLALD(a, b, acc) ((int64_t)__SMLALD((a), (b), (uint64_t)(acc)))
+#else
+// Equivalentes em C para builds sem extensões DSP (mesmo resultado bit a bit)
+static inline uint32_t FIR_ROR16(uint32_t x)
+{
+    return (x >> 16) | (x << 16);
+}
+
+static inline uint32_t FIR_SHADD16(uint32_t a, uint32_t b)
+{
+    int32_t lo = ((int32_t)(int16_t)a + (int32_t)(int16_t)b) >> 1;
+    int32_t hi = ((int32_t)(int16_t)(a >> 16) + (int32_t)(int16_t)(b >> 16)) >> 1;
+    return ((uint32_t)hi << 16) | ((uint32_t)lo & 0xFFFF);
+}
+
+static inline int64_t FIR_SMLALD(uint32_t a, uint32_t b, int64_t acc)
+{
+    return acc + (int32_t)(int16_t)a * (int16_t)b
+               + (int32_t)(int16_t)(a >> 16) * (int16_t)(b >> 16);
+}
+#endif
+
+// Coeficientes gerados offline (windowed-sinc passa-banda 20-400 Hz, Hamming,
+// ganho unitário em 100 Hz). Dobrados: N = 2c + 1 taps guardados em c + 1 posições.
+
+// 63 taps: q[k] = 2*h[k] em Q15 (k < 31), q[31] = h[centro] em Q15
+static const int16_t m_q_63[32] __attribute__((aligned(4))) = {
+        68,     34,     -7,     99,    -64,     79,      0,   -118,
+       142,   -323,     31,   -206,   -530,     89,  -1034,   -213,
+      -744,  -1424,    -49,  -2366,   -554,  -1551,  -2837,    238,
+     -4552,   -308,  -2306,  -5360,   3960, -12372,   9606,  24856,
+};
+
+// 127 taps: q[k] = 2*h[k] em Q15 (k < 63), q[63] = h[centro] em Q15
+static const int16_t m_q_127[64] __attribute__((aligned(4))) = {
+        -1,    -53,    -11,    -28,    -47,      4,    -63,     -4,
+       -26,    -52,     31,    -71,     30,      0,    -37,    106,
+       -57,    114,     69,     12,    243,    -16,    251,    174,
+        79,    422,     11,    399,    261,     94,    575,    -62,
+       473,    235,    -46,    610,   -349,    381,      0,   -439,
+       465,   -939,     81,   -485,  -1131,    173,  -1863,   -356,
+     -1162,  -2090,    -68,  -3122,   -699,  -1875,  -3306,    269,
+     -4995,   -330,  -2421,  -5534,   4038, -12501,   9654,  24936,
+};
+
+static inline uint32_t load_pair(int16_t const * p)
+{
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));   // LDR (acesso desalinhado é permitido no M4)
+    return v;
+}
+
+bool emg_fir_init(emg_fir_t * p_fir, uint16_t taps)
+{
+    if (taps == 63) {
+        p_fir->p_q = m_q_63;
+    } else if (taps == 127) {
+        p_fir->p_q = m_q_127;
+    } else {
+        return false;
+    }
+    p_fir->taps = taps;
+    p_fir->pos  = 0;
+    memset(p_fir->state, 0, sizeof(p_fir->state));
+    return true;
+}
+
+int16_t emg_fir_process(emg_fir_t * p_fir, int16_t sample)
+{
+    uint16_t n = p_fir->taps;
+
+    // Amostra nova nas duas cópias; janela w[0..N-1] (mais antiga → mais nova)
+    p_fir->state[p_fir->pos]     = sample;
+    p_fir->state[p_fir->pos + n] = sample;
+    int16_t const * w = &p_fir->state[p_fir->pos + 1];
+    p_fir->pos = (p_fir->pos + 1 == n) ? 0 : (uint16_t)(p_fir->pos + 1);
+
+    uint32_t const * p_q   = (uint32_t const *)p_fir->p_q;
+    int16_t const *  p_lo  = w;             // w[k], w[k+1]
+    int16_t const *  p_hi  = &w[n - 2];     // w[N-2-k], w[N-1-k]
+    uint16_t         pairs = (uint16_t)((n + 1) / 4);
+    int64_t          acc   = 0;
+
+    for (uint16_t i = 0; i < pairs; i++) {
+        uint32_t a   = load_pair(p_lo);
+        uint32_t b   = FIR_ROR16(load_pair(p_hi));
+        uint32_t sum = FIR_SHADD16(a, b);
+        acc = FIR_SMLALD(sum, p_q[i], acc);
+        p_lo += 2;
+        p_hi -= 2;
+    }
+
+    int32_t y = (int32_t)(acc >> 15);
+    if (y > INT16_MAX) y = INT16_MAX;
+    if (y < INT16_MIN) y = INT16_MIN;
+    return (int16_t)y;
+}
+
+static uint32_t benchmark_taps(uint16_t taps)
+{
+    static emg_fir_t fir;
+    const uint16_t samples = 256;
+    int16_t x = 1;
+
+    emg_fir_init(&fir, taps);
+    uint32_t start = emg_platform_cycles();
+    for (uint16_t i = 0; i < samples; i++) {
+        x = (int16_t)(x * 75 + 74);     // Entrada pseudoaleatória barata
+        (void)emg_fir_process(&fir, x);
+    }
+    return (emg_platform_cycles() - start) / samples;
+}
+
+void emg_fir_benchmark(void)
+{
+    emg_platform_cycles_init();
+
+    uint32_t c63  = benchmark_taps(63);
+    uint32_t c127 = benchmark_taps(127);
+    EMG_LOG_INFO("FIR cycles/sample: 63 taps=%d, 127 taps=%d", c63, c127);
+}
@@ -0,0 +1,38 @@
+#ifndef EMG_FIR_H__
+#define EMG_FIR_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// FIR passa-banda int16 de fase linear (20-400 Hz @ 1kSPS, Hamming).
+// Kernel para Cortex-M4 com extensões DSP:
+//   - dobra simétrica: (x[k] + x[N-1-k]) / 2 via SHADD16, dois pares por palavra
+//   - dual-MAC com acumulador de 64 bits (SMLALD) sobre coeficientes Q15 empacotados
+//   - estado circular duplicado: a janela é sempre contígua, sem teste de wrap
+// O tap central entra "de graça" no último par (requer N = 4m + 3).
+// SHADD16 descarta o LSB da soma dobrada (~ -96 dBFS).
+//
+// Custo estimado por contagem de instruções (-O3, M4 @ 64 MHz, sem wait states):
+//    63 taps: 16 iterações x ~9 ciclos + ~30 de overhead ≈ 175 ciclos/amostra (2.7 us)
+//   127 taps: 32 iterações x ~9 ciclos + ~30 de overhead ≈ 320 ciclos/amostra (5.0 us)
+// emg_fir_benchmark() mede o valor real com o DWT->CYCCNT no alvo.
+//
+// Atraso de grupo: (N - 1) / 2 amostras (31 ms / 63 ms @ 1kSPS).
+#define EMG_FIR_MAX_TAPS              127
+
+typedef struct {
+    int16_t const * p_q;                            // Coeficientes dobrados e empacotados
+    uint16_t        taps;
+    uint16_t        pos;
+    int16_t         state[2 * EMG_FIR_MAX_TAPS];    // Linha de atraso duplicada
+} emg_fir_t;
+
+// taps: 63 ou 127 (tabelas pré-calculadas). Retorna false para outros valores.
+bool emg_fir_init(emg_fir_t * p_fir, uint16_t taps);
+
+int16_t emg_fir_process(emg_fir_t * p_fir, int16_t sample);
+
+// Mede ciclos/amostra para 63 e 127 taps (DWT no alvo, ns no host; via EMG_LOG).
+void emg_fir_benchmark(void);
+
+#endif // EMG_FIR_H__
@@ -0,0 +1,62 @@
+#include "emg_pipeline.h"
+#include "emg_platform.h"
+#include <string.h>
+
+static emg_stage_t const * m_stages;
+static uint8_t             m_count;
+static emg_stage_stats_t   m_stats[EMG_PIPELINE_MAX_STAGES];
+
+bool emg_pipeline_init(emg_stage_t const * p_stages, uint8_t count)
+{
+    if (count > EMG_PIPELINE_MAX_STAGES) {
+        return false;
+    }
+    m_stages = p_stages;
+    m_count  = count;
+    memset(m_stats, 0, sizeof(m_stats));
+
+    emg_platform_cycles_init();
+    return true;
+}
+
+uint16_t emg_pipeline_run(int16_t * p_block, uint16_t n)
+{
+    for (uint8_t i = 0; i < m_count && n > 0; i++) {
+        emg_stage_t const * p_stage = &m_stages[i];
+        if (p_stage->enabled != NULL && !p_stage->enabled()) {
+            continue;
+        }
+
+        uint32_t start = emg_platform_cycles();
+        uint16_t n_out = p_stage->process(p_block, n);
+        uint32_t cycles = emg_platform_cycles() - start;
+
+        emg_stage_stats_t * p_st = &m_stats[i];
+        p_st->cycles += cycles;
+        if (cycles > p_st->max_block_cycles) {
+            p_st->max_block_cycles = cycles;
+        }
+        p_st->samples = (p_st->samples > UINT16_MAX - n) ? UINT16_MAX : (uint16_t)(p_st->samples + n);
+
+        n = n_out;
+    }
+    return n;
+}
+
+uint8_t emg_pipeline_stage_count(void)
+{
+    return m_count;
+}
+
+char const * emg_pipeline_stage_name(uint8_t index)
+{
+    return (index < m_count) ? m_stages[index].name : "";
+}
+
+uint8_t emg_pipeline_take_stats(emg_stage_stats_t * p_stats, uint8_t max)
+{
+    uint8_t n = (m_count < max) ? m_count : max;
+    memcpy(p_stats, m_stats, n * sizeof(emg_stage_stats_t));
+    memset(m_stats, 0, sizeof(m_stats));
+    return n;
+}
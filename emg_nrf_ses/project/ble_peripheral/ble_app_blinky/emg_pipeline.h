@@ -0,0 +1,40 @@
+#ifndef EMG_PIPELINE_H__
+#define EMG_PIPELINE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Grafo de estágios DSP estático: uma tabela de estágios encadeados que
+// processam o mesmo bloco in-place (n_out <= n_in, ex.: decimação).
+// Cada estágio tem o custo medido com o DWT CYCCNT; estágios cujo predicado
+// enabled() retorna false (ninguém inscrito) são pulados sem custo.
+#define EMG_PIPELINE_MAX_STAGES       16
+#define EMG_PIPELINE_BLOCK_LEN        10      // 10 ms @ 1kSPS por execução
+
+typedef struct {
+    char const * name;
+    uint16_t   (*process)(int16_t * p_block, uint16_t n);  // Retorna o número de amostras de saída
+    bool       (*enabled)(void);                            // NULL = sempre ativo
+} emg_stage_t;
+
+// Custo de um estágio desde a última leitura (10 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint32_t cycles;                  // Ciclos acumulados
+    uint32_t max_block_cycles;        // Pior bloco
+    uint16_t samples;                 // Amostras de entrada processadas (0 = pulado)
+} emg_stage_stats_t;
+
+// Registra a tabela (deve permanecer válida). Retorna false se exceder o limite.
+bool emg_pipeline_init(emg_stage_t const * p_stages, uint8_t count);
+
+// Executa todos os estágios sobre o bloco. Retorna o tamanho final do bloco.
+uint16_t emg_pipeline_run(int16_t * p_block, uint16_t n);
+
+uint8_t emg_pipeline_stage_count(void);
+
+char const * emg_pipeline_stage_name(uint8_t index);
+
+// Copia o custo por estágio (na ordem da tabela) e zera os contadores.
+uint8_t emg_pipeline_take_stats(emg_stage_stats_t * p_stats, uint8_t max);
+
+#endif // EMG_PIPELINE_H__
@@ -0,0 +1,56 @@
+#ifndef EMG_PLATFORM_H__
+#define EMG_PLATFORM_H__
+
+#include <stdint.h>
+
+// Dependências de alvo dos módulos de DSP: contador de ciclos, barreira de
+// memória, asserção estática e log. No nRF52840 usam o DWT, o CMSIS e o NRF_LOG;
+// com -DEMG_HOST (host/Makefile) os mesmos fontes compilam no PC.
+#ifdef EMG_HOST
+
+#include <time.h>
+
+void emg_host_log(char const * p_level, char const * p_fmt, ...);
+
+// Sem DWT no host: nanossegundos do relógio monotônico (só diferenças importam)
+static inline void emg_platform_cycles_init(void)
+{
+}
+
+static inline uint32_t emg_platform_cycles(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint32_t)((uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec);
+}
+
+#define EMG_PLATFORM_DMB()            __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#define EMG_STATIC_ASSERT(cond)       _Static_assert(cond, #cond)
+#define EMG_LOG_INFO(...)             emg_host_log("info", __VA_ARGS__)
+#define EMG_LOG_WARNING(...)          emg_host_log("warning", __VA_ARGS__)
+
+#else
+
+#include "nrf.h"
+#include "app_util.h"
+#include "nrf_log.h"
+
+static inline void emg_platform_cycles_init(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+static inline uint32_t emg_platform_cycles(void)
+{
+    return DWT->CYCCNT;
+}
+
+#define EMG_PLATFORM_DMB()            __DMB()
+#define EMG_STATIC_ASSERT(cond)       STATIC_ASSERT(cond)
+#define EMG_LOG_INFO(...)             NRF_LOG_INFO(__VA_ARGS__)
+#define EMG_LOG_WARNING(...)          NRF_LOG_WARNING(__VA_ARGS__)
+
+#endif // EMG_HOST
+
+#endif // EMG_PLATFORM_H__
@@ -0,0 +1,59 @@
+#include "emg_prefilter.h"
+#include "emg_config.h"
+#include <math.h>
+
+#define PI_F 3.14159265358979f
+
+static emg_offset_t m_offset;
+
+// Biquad na forma direta II transposta
+static float m_b0, m_b1, m_b2, m_a1, m_a2;
+static emg_notch_t m_notch;
+
+void emg_prefilter_init(void)
+{
+    m_offset.x1 = m_offset.y1 = 0.0f;
+
+    float w0    = 2.0f * PI_F * EMG_NOTCH_HZ / (float)EMG_SAMPLE_RATE_HZ;
+    float alpha = sinf(w0) / (2.0f * EMG_NOTCH_Q);
+    float a0    = 1.0f + alpha;
+    m_b0 = 1.0f / a0;
+    m_b1 = -2.0f * cosf(w0) / a0;
+    m_b2 = 1.0f / a0;
+    m_a1 = -2.0f * cosf(w0) / a0;
+    m_a2 = (1.0f - alpha) / a0;
+    m_notch.z1 = m_notch.z2 = 0.0f;
+}
+
+static int16_t saturate(float y)
+{
+    if (y > 32767.0f)  return INT16_MAX;
+    if (y < -32768.0f) return INT16_MIN;
+    return (int16_t)lrintf(y);
+}
+
+float emg_offset_step(emg_offset_t * p_state, float x)
+{
+    float y = x - p_state->x1 + EMG_OFFSET_POLE * p_state->y1;
+    p_state->x1 = x;
+    p_state->y1 = y;
+    return y;
+}
+
+float emg_notch_step(emg_notch_t * p_state, float x)
+{
+    float y = m_b0 * x + p_state->z1;
+    p_state->z1 = m_b1 * x - m_a1 * y + p_state->z2;
+    p_state->z2 = m_b2 * x - m_a2 * y;
+    return y;
+}
+
+int16_t emg_offset_process(int16_t sample)
+{
+    return saturate(emg_offset_step(&m_offset, (float)sample));
+}
+
+int16_t emg_notch_process(int16_t sample)
+{
+    return saturate(emg_notch_step(&m_notch, (float)sample));
+}
@@ -0,0 +1,36 @@
+#ifndef EMG_PREFILTER_H__
+#define EMG_PREFILTER_H__
+
+#include <stdint.h>
+
+// Estágios de condicionamento antes do passa-banda:
+//   - remoção de offset: bloqueador de DC de 1 polo (fc ~0.8 Hz @ 1kSPS)
+//   - notch da rede elétrica: biquad IIR (RBJ) com Q alto
+#define EMG_OFFSET_POLE               0.995f
+
+#ifndef EMG_NOTCH_HZ
+#define EMG_NOTCH_HZ                  60.0f   // Rede brasileira; usar 50.0f na Europa
+#endif
+#define EMG_NOTCH_Q                   30.0f   // Largura de ~2 Hz
+
+// Estado por canal: o pipeline usa uma instância interna, a análise entre
+// canais (emg_cross.c) uma por canal, com os mesmos coeficientes
+typedef struct {
+    float x1, y1;
+} emg_offset_t;
+
+typedef struct {
+    float z1, z2;
+} emg_notch_t;
+
+void emg_prefilter_init(void);
+
+int16_t emg_offset_process(int16_t sample);
+
+int16_t emg_notch_process(int16_t sample);
+
+float emg_offset_step(emg_offset_t * p_state, float x);
+
+float emg_notch_step(emg_notch_t * p_state, float x);
+
+#endif // EMG_PREFILTER_H__
@@ -0,0 +1,105 @@
+#include "emg_quality.h"
+#include "emg_config.h"
+#include <math.h>
+
+#define PI_F 3.14159265358979f
+
+// DC muito lento (~0.15 Hz) e passa-baixas de 1ª ordem em 20 Hz
+#define DC_ALPHA    0.001f
+
+static float    m_lf_alpha;
+static float    m_dc;
+static float    m_lf;
+static bool     m_dc_valid;
+
+// Acumuladores do bloco atual de um stream
+typedef struct {
+    int16_t  min;
+    int16_t  max;
+    bool     clipped;
+    float    lf_energy;
+    float    hf_energy;
+    uint32_t count;
+    uint16_t marks;                 // Marcas externas (trigger) do bloco
+} quality_block_t;
+
+static quality_block_t m_blocks[EMG_QUALITY_VIEW_COUNT];
+
+static void block_reset(quality_block_t * p_block)
+{
+    p_block->min = INT16_MAX;
+    p_block->max = INT16_MIN;
+    p_block->clipped = false;
+    p_block->lf_energy = 0.0f;
+    p_block->hf_energy = 0.0f;
+    p_block->count = 0;
+    p_block->marks = 0;
+}
+
+void emg_quality_init(void)
+{
+    m_lf_alpha = 1.0f - expf(-2.0f * PI_F * EMG_QUALITY_LF_CUTOFF_HZ / (float)EMG_SAMPLE_RATE_HZ);
+    m_dc = 0.0f;
+    m_lf = 0.0f;
+    m_dc_valid = false;
+    for (uint8_t v = 0; v < EMG_QUALITY_VIEW_COUNT; v++) {
+        block_reset(&m_blocks[v]);
+    }
+}
+
+void emg_quality_push_raw(int16_t raw)
+{
+    bool clipped = (raw >= EMG_QUALITY_CLIP_LEVEL || raw <= -EMG_QUALITY_CLIP_LEVEL);
+
+    float x = (float)raw;
+    if (!m_dc_valid) {
+        m_dc = x;
+        m_dc_valid = true;
+    }
+    m_dc += DC_ALPHA * (x - m_dc);
+
+    float ac = x - m_dc;
+    m_lf += m_lf_alpha * (ac - m_lf);
+    float hf = ac - m_lf;
+
+    // Detectores compartilhados; cada stream acumula o próprio bloco
+    for (uint8_t v = 0; v < EMG_QUALITY_VIEW_COUNT; v++) {
+        quality_block_t * p_block = &m_blocks[v];
+        if (raw < p_block->min) p_block->min = raw;
+        if (raw > p_block->max) p_block->max = raw;
+        p_block->clipped   |= clipped;
+        p_block->lf_energy += m_lf * m_lf;
+        p_block->hf_energy += hf * hf;
+        p_block->count++;
+    }
+}
+
+void emg_quality_mark(uint16_t flags)
+{
+    for (uint8_t v = 0; v < EMG_QUALITY_VIEW_COUNT; v++) {
+        m_blocks[v].marks |= flags;
+    }
+}
+
+uint16_t emg_quality_take_flags(emg_quality_view_t view)
+{
+    quality_block_t * p_block = &m_blocks[view];
+    uint16_t flags = p_block->marks;
+
+    if (p_block->count > 0) {
+        if (p_block->clipped) {
+            flags |= EMG_QUALITY_FLAG_CLIPPING;
+        }
+        if ((int32_t)p_block->max - (int32_t)p_block->min <= EMG_QUALITY_FLAT_PP) {
+            flags |= EMG_QUALITY_FLAG_FLATLINE;
+        }
+        float lf_rms = sqrtf(p_block->lf_energy / (float)p_block->count);
+        if (lf_rms > EMG_QUALITY_MOTION_MIN_RMS &&
+            p_block->lf_energy > EMG_QUALITY_MOTION_RATIO * p_block->hf_energy) {
+            flags |= EMG_QUALITY_FLAG_MOTION;
+        }
+    }
+
+    block_reset(p_block);
+    return flags;
+}
@@ -0,0 +1,42 @@
+#ifndef EMG_QUALITY_H__
+#define EMG_QUALITY_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Detectores de qualidade por bloco, aplicados ao sinal bruto do ADC
+// (antes do passa-banda). O bloco é o conjunto de amostras que entrou
+// no pacote BLE atual; cada stream (filtrado, bruto) tem o próprio bloco,
+// fechado por emg_quality_take_flags() quando o seu pacote é montado.
+#define EMG_QUALITY_FLAG_CLIPPING     0x0001  // Saturação do ADC (|x| >= EMG_QUALITY_CLIP_LEVEL)
+#define EMG_QUALITY_FLAG_MOTION       0x0002  // Energia < 20 Hz domina a banda EMG
+#define EMG_QUALITY_FLAG_FLATLINE     0x0004  // Entrada parada/desconectada
+#define EMG_QUALITY_FLAG_TRIGGER      0x0008  // Trigger externo no bloco (índice exato no evento)
+#define EMG_QUALITY_FLAG_RATE_CHANGE  0x0010  // Primeira amostra numa nova taxa adaptativa (posição no evento)
+#define EMG_QUALITY_FLAG_SEQ_GAP      0x0020  // Pacotes anteriores a este seguiram pelo backlog
+#define EMG_QUALITY_FLAG_GAIN_CHANGE  0x0040  // Troca de ganho no meio do pacote (época no header v2)
+
+#define EMG_QUALITY_CLIP_LEVEL        32000   // Margem abaixo de ±32767
+#define EMG_QUALITY_FLAT_PP           4       // Pico-a-pico máximo (contagens) de um bloco "flat"
+#define EMG_QUALITY_MOTION_RATIO      4.0f    // Energia LF / energia HF para sinalizar artefato
+#define EMG_QUALITY_MOTION_MIN_RMS    200.0f  // RMS LF mínimo (evita falso positivo em repouso)
+#define EMG_QUALITY_LF_CUTOFF_HZ      20.0f
+
+typedef enum {
+    EMG_QUALITY_VIEW_FILTERED = 0,
+    EMG_QUALITY_VIEW_RAW,
+    EMG_QUALITY_VIEW_COUNT
+} emg_quality_view_t;
+
+void emg_quality_init(void);
+
+// Atualiza os detectores com uma amostra bruta do ADC.
+void emg_quality_push_raw(int16_t raw);
+
+// Marca o bloco atual dos dois streams com flags externas (ex.: EMG_QUALITY_FLAG_TRIGGER).
+void emg_quality_mark(uint16_t flags);
+
+// Retorna as flags do bloco atual do stream e inicia um novo bloco.
+uint16_t emg_quality_take_flags(emg_quality_view_t view);
+
+#endif // EMG_QUALITY_H__
@@ -0,0 +1,101 @@
+#include "emg_sched.h"
+#include "app_scheduler.h"
+#include "app_timer.h"
+#include <string.h>
+
+typedef struct {
+    uint8_t  type;
+    uint32_t posted;                  // Ticks do RTC na postagem
+} sched_evt_t;
+
+static emg_sched_event_t const * m_events;
+static uint8_t                   m_count;
+static volatile bool             m_pending[EMG_SCHED_MAX_EVENTS];
+static emg_sched_stats_t         m_stats[EMG_SCHED_MAX_EVENTS];
+
+static uint32_t ticks_to_us(uint32_t ticks)
+{
+    return (uint32_t)(((uint64_t)ticks * 1000000u) / APP_TIMER_CLOCK_FREQ);
+}
+
+static void dispatch(void * p_event_data, uint16_t event_size)
+{
+    sched_evt_t const * p_evt = (sched_evt_t const *)p_event_data;
+    emg_sched_event_t const * p_desc = &m_events[p_evt->type];
+
+    // Limpo antes do handler: postagem durante a execução gera nova rodada
+    m_pending[p_evt->type] = false;
+    p_desc->handler();
+
+    uint32_t latency = ticks_to_us(app_timer_cnt_diff_compute(app_timer_cnt_get(), p_evt->posted));
+    emg_sched_stats_t * p_st = &m_stats[p_evt->type];
+    p_st->events++;
+    if (latency > p_desc->deadline_us) {
+        p_st->missed++;
+    }
+    if (latency > p_st->max_latency_us) {
+        p_st->max_latency_us = latency;
+    }
+}
+
+bool emg_sched_init(emg_sched_event_t const * p_events, uint8_t count)
+{
+    if (count > EMG_SCHED_MAX_EVENTS) {
+        return false;
+    }
+    m_events = p_events;
+    m_count  = count;
+    memset(m_stats, 0, sizeof(m_stats));
+    for (uint8_t i = 0; i < count; i++) {
+        m_pending[i] = false;
+    }
+
+    APP_SCHED_INIT(sizeof(sched_evt_t), EMG_SCHED_QUEUE_SIZE);
+    return true;
+}
+
+void emg_sched_post(uint8_t type)
+{
+    if (type >= m_count) {
+        return;
+    }
+    if (m_events[type].coalesce) {
+        if (m_pending[type]) {
+            return;
+        }
+        m_pending[type] = true;
+    }
+
+    sched_evt_t evt = { .type = type, .posted = app_timer_cnt_get() };
+    if (app_sched_event_put(&evt, sizeof(evt), dispatch) != NRF_SUCCESS) {
+        m_pending[type] = false;
+        if (m_stats[type].dropped < UINT16_MAX) {
+            m_stats[type].dropped++;
+        }
+    }
+}
+
+void emg_sched_execute(void)
+{
+    app_sched_execute();
+}
+
+// Loop único: handlers nunca se interrompem
+void emg_sched_lock(void)
+{
+}
+
+void emg_sched_unlock(void)
+{
+}
+
+uint8_t emg_sched_take_stats(emg_sched_stats_t * p_stats, uint8_t max)
+{
+    uint8_t n = (m_count < max) ? m_count : max;
+    for (uint8_t i = 0; i < n; i++) {
+        m_stats[i].deadline_us = (uint16_t)MIN(m_events[i].deadline_us, UINT16_MAX);
+    }
+    memcpy(p_stats, m_stats, n * sizeof(emg_sched_stats_t));
+    memset(m_stats, 0, sizeof(m_stats));
+    return n;
+}
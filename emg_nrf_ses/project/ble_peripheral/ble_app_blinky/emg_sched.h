@@ -0,0 +1,64 @@
+#ifndef EMG_SCHED_H__
+#define EMG_SCHED_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Loop principal orientado a eventos sobre o app_scheduler: ISRs e callbacks
+// só postam o tipo do evento; o handler roda no contexto principal. Cada tipo
+// tem um prazo (postagem → fim do handler, medido no RTC do app_timer) e
+// contadores de prazos perdidos, para achar o handler que estoura a latência.
+//
+// Dois backends com a mesma API: emg_sched.c (app_scheduler, loop único) e
+// emg_sched_freertos.c (variante EMG_RTOS: uma tarefa por emg_sched_task_t,
+// eventos como bits de notificação da tarefa).
+#define EMG_SCHED_MAX_EVENTS          12
+#define EMG_SCHED_QUEUE_SIZE          32
+
+// Tarefa que executa o evento na variante FreeRTOS (ignorado no loop único)
+typedef enum {
+    EMG_SCHED_TASK_ACQ = 0,           // Prioridade alta: leitura do ADC, só I2C
+    EMG_SCHED_TASK_DSP,               // Média: pipeline sobre os blocos prontos
+    EMG_SCHED_TASK_RADIO,             // Baixa: empacotamento, BLE, configuração e telemetria
+    EMG_SCHED_TASK_COUNT
+} emg_sched_task_t;
+
+typedef struct {
+    char const * name;
+    void       (*handler)(void);
+    uint32_t     deadline_us;
+    bool         coalesce;            // Só um pendente por vez (estado é relido no handler)
+    uint8_t      task;                // emg_sched_task_t
+} emg_sched_event_t;
+
+// Contadores de um tipo de evento desde a última leitura (16 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint32_t events;                  // Handlers executados
+    uint32_t missed;                  // Terminaram depois do prazo
+    uint16_t dropped;                 // Fila do scheduler cheia
+    uint16_t deadline_us;
+    uint32_t max_latency_us;          // Pior postagem → fim do handler
+} emg_sched_stats_t;
+
+// Registra a tabela (índice = tipo do evento, deve permanecer válida) e inicia
+// o app_scheduler (ou cria as tarefas, antes de vTaskStartScheduler()).
+// Retorna false se exceder o limite.
+bool emg_sched_init(emg_sched_event_t const * p_events, uint8_t count);
+
+// Posta um evento (seguro em ISR). Eventos coalescidos já pendentes são ignorados;
+// na variante FreeRTOS um evento não coalescido ainda pendente conta como perdido.
+void emg_sched_post(uint8_t type);
+
+// Executa os eventos pendentes, em ordem de postagem (só no loop único).
+void emg_sched_execute(void);
+
+// Estado do DSP compartilhado entre as tarefas DSP e rádio (configuração,
+// bursts, flags de qualidade). Mutex com herança de prioridade na variante
+// FreeRTOS; sem efeito no loop único. A tarefa de aquisição nunca o usa.
+void emg_sched_lock(void);
+void emg_sched_unlock(void);
+
+// Copia os contadores por tipo (na ordem da tabela) e zera.
+uint8_t emg_sched_take_stats(emg_sched_stats_t * p_stats, uint8_t max);
+
+#endif // EMG_SCHED_H__
@@ -0,0 +1,173 @@
+#include "emg_sched.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "semphr.h"
+#include "nrf.h"
+#include "app_error.h"
+#include "app_util.h"
+#include <string.h>
+
+// Variante FreeRTOS do loop por eventos: cada evento roda na tarefa indicada na
+// tabela. O evento é um bit da notificação da tarefa (sem fila nem lock no
+// caminho da ISR); os dados passam pelos buffers ping-pong do ADC e pelo ring
+// SPSC do emg_store. A tarefa da SoftDevice (nrf_sdh_freertos, prioridade 2)
+// fica entre o DSP e o rádio.
+#define EMG_SCHED_ACQ_PRIORITY        4
+#define EMG_SCHED_DSP_PRIORITY        3
+#define EMG_SCHED_RADIO_PRIORITY      1
+
+#define EMG_SCHED_ACQ_STACK           256     // Palavras
+#define EMG_SCHED_DSP_STACK           1024    // FFT/Welch/features
+#define EMG_SCHED_RADIO_STACK         1024    // Codec: encode (~1.5 KB) + verificação por decode
+
+STATIC_ASSERT(EMG_SCHED_MAX_EVENTS <= 32);   // Um bit de notificação por evento
+
+static const struct {
+    char const * name;
+    UBaseType_t  priority;
+    uint16_t     stack;
+} m_task_cfg[EMG_SCHED_TASK_COUNT] = {
+    [EMG_SCHED_TASK_ACQ]   = { "ACQ", EMG_SCHED_ACQ_PRIORITY,   EMG_SCHED_ACQ_STACK   },
+    [EMG_SCHED_TASK_DSP]   = { "DSP", EMG_SCHED_DSP_PRIORITY,   EMG_SCHED_DSP_STACK   },
+    [EMG_SCHED_TASK_RADIO] = { "RAD", EMG_SCHED_RADIO_PRIORITY, EMG_SCHED_RADIO_STACK },
+};
+
+static emg_sched_event_t const * m_events;
+static uint8_t                   m_count;
+static TaskHandle_t              m_tasks[EMG_SCHED_TASK_COUNT];
+static SemaphoreHandle_t         m_lock;
+static volatile bool             m_pending[EMG_SCHED_MAX_EVENTS];
+static volatile uint32_t         m_posted[EMG_SCHED_MAX_EVENTS];    // CYCCNT na postagem
+static emg_sched_stats_t         m_stats[EMG_SCHED_MAX_EVENTS];
+
+// Latência em ciclos: o RTC1 é do tick do FreeRTOS (1 ms, grosso demais para os
+// prazos). Com um evento pendente a tarefa está pronta e a CPU não dorme.
+static uint32_t cycles_to_us(uint32_t cycles)
+{
+    return cycles / (SystemCoreClock / 1000000u);
+}
+
+static void dispatch(uint8_t type)
+{
+    emg_sched_event_t const * p_desc = &m_events[type];
+
+    m_pending[type] = false;
+    p_desc->handler();
+
+    uint32_t latency = cycles_to_us(DWT->CYCCNT - m_posted[type]);
+    emg_sched_stats_t * p_st = &m_stats[type];
+    p_st->events++;
+    if (latency > p_desc->deadline_us) {
+        p_st->missed++;
+    }
+    if (latency > p_st->max_latency_us) {
+        p_st->max_latency_us = latency;
+    }
+}
+
+static void task_loop(void * p_context)
+{
+    for (;;) {
+        uint32_t bits;
+        (void)xTaskNotifyWait(0, UINT32_MAX, &bits, portMAX_DELAY);
+        // Ordem da tabela dentro da tarefa
+        for (uint8_t type = 0; type < m_count; type++) {
+            if (bits & (1UL << type)) {
+                dispatch(type);
+            }
+        }
+    }
+}
+
+bool emg_sched_init(emg_sched_event_t const * p_events, uint8_t count)
+{
+    if (count > EMG_SCHED_MAX_EVENTS) {
+        return false;
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        if (p_events[i].task >= EMG_SCHED_TASK_COUNT) {
+            return false;
+        }
+        m_pending[i] = false;
+    }
+    m_events = p_events;
+    m_count  = count;
+    memset(m_stats, 0, sizeof(m_stats));
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    m_lock = xSemaphoreCreateMutex();
+    if (m_lock == NULL) {
+        return false;
+    }
+    for (uint8_t t = 0; t < EMG_SCHED_TASK_COUNT; t++) {
+        if (xTaskCreate(task_loop, m_task_cfg[t].name, m_task_cfg[t].stack,
+                        NULL, m_task_cfg[t].priority, &m_tasks[t]) != pdPASS) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void emg_sched_post(uint8_t type)
+{
+    if (type >= m_count) {
+        return;
+    }
+    if (m_pending[type]) {
+        // Coalescido: o handler relê o estado. Senão a tarefa não acompanhou
+        if (!m_events[type].coalesce && m_stats[type].dropped < UINT16_MAX) {
+            m_stats[type].dropped++;
+        }
+        return;
+    }
+    m_posted[type]  = DWT->CYCCNT;
+    m_pending[type] = true;
+
+    TaskHandle_t task = m_tasks[m_events[type].task];
+    if (__get_IPSR() != 0) {
+        BaseType_t woken = pdFALSE;
+        (void)xTaskNotifyFromISR(task, 1UL << type, eSetBits, &woken);
+        portYIELD_FROM_ISR(woken);
+    } else {
+        (void)xTaskNotify(task, 1UL << type, eSetBits);
+    }
+}
+
+// configCHECK_FOR_STACK_OVERFLOW 2: estouro de pilha vira erro fatal em vez de
+// corromper em silêncio a memória vizinha
+void vApplicationStackOverflowHook(TaskHandle_t task, char * p_name)
+{
+    UNUSED_PARAMETER(task);
+    UNUSED_PARAMETER(p_name);
+    APP_ERROR_HANDLER(NRF_ERROR_NO_MEM);
+}
+
+void emg_sched_execute(void)
+{
+    // Eventos rodam nas tarefas
+}
+
+void emg_sched_lock(void)
+{
+    (void)xSemaphoreTake(m_lock, portMAX_DELAY);
+}
+
+void emg_sched_unlock(void)
+{
+    (void)xSemaphoreGive(m_lock);
+}
+
+uint8_t emg_sched_take_stats(emg_sched_stats_t * p_stats, uint8_t max)
+{
+    uint8_t n = (m_count < max) ? m_count : max;
+    for (uint8_t i = 0; i < n; i++) {
+        m_stats[i].deadline_us = (uint16_t)MIN(m_events[i].deadline_us, UINT16_MAX);
+    }
+    taskENTER_CRITICAL();
+    memcpy(p_stats, m_stats, n * sizeof(emg_sched_stats_t));
+    memset(m_stats, 0, sizeof(m_stats));
+    taskEXIT_CRITICAL();
+    return n;
+}
@@ -0,0 +1,99 @@
+#include "emg_spectral.h"
+#include "emg_config.h"
+#include "emg_fft.h"
+#include <math.h>
+#include <string.h>
+
+#define PI_F 3.14159265358979f
+
+static emg_rfft_t m_fft;
+static float      m_window[EMG_SPECTRAL_FFT_LEN];     // Hann pré-calculada
+static float      m_work[EMG_SPECTRAL_FFT_LEN];       // FFT e espectro de potência, in-place
+static int16_t    m_frame[EMG_SPECTRAL_FFT_LEN];      // Histórico de amostras
+static uint16_t   m_fill = 0;
+static uint16_t   m_window_seq = 0;
+static uint16_t   m_bin_low;
+static uint16_t   m_bin_high;
+static float      m_power_scale;                      // 2 / (N * sum(w²))
+
+void emg_spectral_init(void)
+{
+    float w_energy = 0.0f;
+    for (uint16_t i = 0; i < EMG_SPECTRAL_FFT_LEN; i++) {
+        m_window[i] = 0.5f - 0.5f * cosf(2.0f * PI_F * (float)i / (float)EMG_SPECTRAL_FFT_LEN);
+        w_energy += m_window[i] * m_window[i];
+    }
+    m_power_scale = 2.0f / ((float)EMG_SPECTRAL_FFT_LEN * w_energy);
+
+    m_bin_low  = (uint16_t)((EMG_SPECTRAL_BAND_LOW_HZ * EMG_SPECTRAL_FFT_LEN + EMG_SAMPLE_RATE_HZ - 1)
+                            / EMG_SAMPLE_RATE_HZ);
+    m_bin_high = (uint16_t)((EMG_SPECTRAL_BAND_HIGH_HZ * EMG_SPECTRAL_FFT_LEN) / EMG_SAMPLE_RATE_HZ);
+    if (m_bin_low < 1) m_bin_low = 1;
+    if (m_bin_high > EMG_SPECTRAL_FFT_LEN / 2 - 1) m_bin_high = EMG_SPECTRAL_FFT_LEN / 2 - 1;
+
+    emg_rfft_init(&m_fft, EMG_SPECTRAL_FFT_LEN);
+    m_fill = 0;
+    m_window_seq = 0;
+}
+
+static void process_window(emg_fatigue_metrics_t * p_metrics)
+{
+    const float bin_hz = (float)EMG_SAMPLE_RATE_HZ / (float)EMG_SPECTRAL_FFT_LEN;
+
+    for (uint16_t i = 0; i < EMG_SPECTRAL_FFT_LEN; i++) {
+        m_work[i] = (float)m_frame[i] * m_window[i];
+    }
+    emg_rfft(&m_fft, m_work);
+
+    // Espectro de potência sobrescreve a primeira metade do buffer (bin k em m_work[k])
+    float total = 0.0f;
+    float moment = 0.0f;
+    for (uint16_t k = m_bin_low; k <= m_bin_high; k++) {
+        float re = m_work[2 * k];
+        float im = m_work[2 * k + 1];
+        float p  = re * re + im * im;
+        m_work[k] = p;
+        total  += p;
+        moment += p * (float)k;
+    }
+
+    float mnf = 0.0f;
+    float mdf = 0.0f;
+    if (total > 0.0f) {
+        mnf = (moment / total) * bin_hz;
+
+        // Mediana: primeiro bin onde a potência acumulada atinge metade do total,
+        // interpolado linearmente dentro do bin
+        float half = 0.5f * total;
+        float acc  = 0.0f;
+        for (uint16_t k = m_bin_low; k <= m_bin_high; k++) {
+            if (acc + m_work[k] >= half) {
+                float frac = (half - acc) / m_work[k];
+                mdf = ((float)k - 0.5f + frac) * bin_hz;
+                break;
+            }
+            acc += m_work[k];
+        }
+    }
+
+    p_metrics->window_seq  = m_window_seq++;
+    p_metrics->mnf_dhz     = (uint16_t)(mnf * 10.0f + 0.5f);
+    p_metrics->mdf_dhz     = (uint16_t)(mdf * 10.0f + 0.5f);
+    p_metrics->total_power = total * m_power_scale;
+}
+
+bool emg_spectral_push(int16_t sample, emg_fatigue_metrics_t * p_metrics)
+{
+    m_frame[m_fill++] = sample;
+    if (m_fill < EMG_SPECTRAL_FFT_LEN) {
+        return false;
+    }
+
+    process_window(p_metrics);
+
+    // Sobreposição: mantém as últimas (N - hop) amostras para a próxima janela
+    memmove(m_frame, &m_frame[EMG_SPECTRAL_HOP],
+            (EMG_SPECTRAL_FFT_LEN - EMG_SPECTRAL_HOP) * sizeof(int16_t));
+    m_fill = EMG_SPECTRAL_FFT_LEN - EMG_SPECTRAL_HOP;
+    return true;
+}
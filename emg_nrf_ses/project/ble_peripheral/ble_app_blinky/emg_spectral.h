@@ -0,0 +1,31 @@
+#ifndef EMG_SPECTRAL_H__
+#define EMG_SPECTRAL_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Métricas espectrais de fadiga (MNF/MDF) por janela.
+// Janela Hann de 256 pontos com 50% de sobreposição:
+//   @1kSPS → resolução de ~3.9 Hz e um resultado a cada 128 ms
+#define EMG_SPECTRAL_FFT_LEN          256
+#define EMG_SPECTRAL_HOP              (EMG_SPECTRAL_FFT_LEN / 2)
+
+// Faixa usada no cálculo (banda útil do EMG de superfície)
+#define EMG_SPECTRAL_BAND_LOW_HZ      20
+#define EMG_SPECTRAL_BAND_HIGH_HZ     450
+
+// Payload da característica de fadiga (10 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint16_t window_seq;    // Contador de janelas (detecta perdas no host)
+    uint16_t mnf_dhz;       // Mean frequency em décimos de Hz
+    uint16_t mdf_dhz;       // Median frequency em décimos de Hz
+    float    total_power;   // Potência na banda, em contagens² do ADC
+} emg_fatigue_metrics_t;
+
+void emg_spectral_init(void);
+
+// Acumula uma amostra filtrada. Retorna true quando uma nova janela foi
+// processada e p_metrics contém o resultado.
+bool emg_spectral_push(int16_t sample, emg_fatigue_metrics_t * p_metrics);
+
+#endif // EMG_SPECTRAL_H__
@@ -0,0 +1,187 @@
+#include "emg_stats.h"
+#include "emg_config.h"
+#include <math.h>
+
+static emg_p2_t m_amp_p50, m_amp_p90, m_amp_p99;
+static emg_p2_t m_rms_p10, m_rms_p50, m_rms_p90;
+static uint32_t m_samples;
+static uint32_t m_active_samples;
+static uint32_t m_rms_windows;
+static uint64_t m_rms_acc;
+static uint16_t m_rms_fill;
+static uint16_t m_publish_count;
+
+// === P² ===
+
+void emg_p2_init(emg_p2_t * p_est, float p)
+{
+    p_est->p = p;
+    p_est->count = 0;
+}
+
+static float parabolic(emg_p2_t const * e, uint8_t i, int32_t s)
+{
+    float n_lo = (float)(e->n[i] - e->n[i - 1]);
+    float n_hi = (float)(e->n[i + 1] - e->n[i]);
+    float span = (float)(e->n[i + 1] - e->n[i - 1]);
+    return e->q[i] + (float)s / span *
+           ((n_lo + (float)s) * (e->q[i + 1] - e->q[i]) / n_hi +
+            (n_hi - (float)s) * (e->q[i] - e->q[i - 1]) / n_lo);
+}
+
+static float linear(emg_p2_t const * e, uint8_t i, int32_t s)
+{
+    return e->q[i] + (float)s * (e->q[i + s] - e->q[i]) / (float)(e->n[i + s] - e->n[i]);
+}
+
+void emg_p2_push(emg_p2_t * e, float x)
+{
+    // Fase inicial: as 5 primeiras amostras, ordenadas, viram os marcadores
+    if (e->count < 5) {
+        uint8_t j = (uint8_t)e->count++;
+        while (j > 0 && e->q[j - 1] > x) {
+            e->q[j] = e->q[j - 1];
+            j--;
+        }
+        e->q[j] = x;
+
+        if (e->count == 5) {
+            float p = e->p;
+            float desired[5] = { 0.0f, 2.0f * p, 4.0f * p, 2.0f + 2.0f * p, 4.0f };
+            for (uint8_t i = 0; i < 5; i++) {
+                e->n[i] = i;
+                e->d[i] = desired[i] - (float)i;
+            }
+        }
+        return;
+    }
+    e->count++;
+
+    // Célula k onde x caiu; estende os extremos se necessário
+    uint8_t k;
+    if (x < e->q[0]) {
+        e->q[0] = x;
+        k = 0;
+    } else if (x >= e->q[4]) {
+        e->q[4] = x;
+        k = 3;
+    } else {
+        k = 0;
+        while (k < 3 && x >= e->q[k + 1]) {
+            k++;
+        }
+    }
+
+    // Posições desejadas avançam dn = {0, p/2, p, (1+p)/2, 1}; as reais só acima de k.
+    // Guardar a diferença mantém a precisão do float em sessões de horas.
+    float p = e->p;
+    float dn[5] = { 0.0f, 0.5f * p, p, 0.5f * (1.0f + p), 1.0f };
+    for (uint8_t i = 0; i < 5; i++) {
+        e->d[i] += dn[i];
+        if (i > k) {
+            e->n[i]++;
+            e->d[i] -= 1.0f;
+        }
+    }
+
+    for (uint8_t i = 1; i <= 3; i++) {
+        float d = e->d[i];
+        if ((d >= 1.0f && e->n[i + 1] - e->n[i] > 1) ||
+            (d <= -1.0f && e->n[i - 1] - e->n[i] < -1)) {
+            int32_t s = (d >= 0.0f) ? 1 : -1;
+            float qp = parabolic(e, i, s);
+            if (e->q[i - 1] < qp && qp < e->q[i + 1]) {
+                e->q[i] = qp;
+            } else {
+                e->q[i] = linear(e, i, s);
+            }
+            e->n[i] += s;
+            e->d[i] -= (float)s;
+        }
+    }
+}
+
+float emg_p2_value(emg_p2_t const * e)
+{
+    if (e->count == 0) {
+        return 0.0f;
+    }
+    if (e->count < 5) {
+        // Poucas amostras: quantil direto das ordenadas
+        uint8_t idx = (uint8_t)(e->p * (float)(e->count - 1) + 0.5f);
+        return e->q[idx];
+    }
+    return e->q[2];
+}
+
+// === Sessão ===
+
+void emg_stats_init(void)
+{
+    emg_p2_init(&m_amp_p50, 0.50f);
+    emg_p2_init(&m_amp_p90, 0.90f);
+    emg_p2_init(&m_amp_p99, 0.99f);
+    emg_p2_init(&m_rms_p10, 0.10f);
+    emg_p2_init(&m_rms_p50, 0.50f);
+    emg_p2_init(&m_rms_p90, 0.90f);
+    m_samples = 0;
+    m_active_samples = 0;
+    m_rms_windows = 0;
+    m_rms_acc = 0;
+    m_rms_fill = 0;
+    m_publish_count = 0;
+}
+
+static uint16_t to_u16(float v)
+{
+    if (v <= 0.0f)     return 0;
+    if (v >= 65535.0f) return UINT16_MAX;
+    return (uint16_t)(v + 0.5f);
+}
+
+void emg_stats_snapshot(emg_stats_snapshot_t * p_snap)
+{
+    p_snap->samples       = m_samples;
+    p_snap->duty_permille = (m_samples > 0) ?
+                            (uint16_t)(((uint64_t)m_active_samples * 1000u) / m_samples) : 0;
+    p_snap->amp_p50       = to_u16(emg_p2_value(&m_amp_p50));
+    p_snap->amp_p90       = to_u16(emg_p2_value(&m_amp_p90));
+    p_snap->amp_p99       = to_u16(emg_p2_value(&m_amp_p99));
+    p_snap->rms_p10       = to_u16(emg_p2_value(&m_rms_p10));
+    p_snap->rms_p50       = to_u16(emg_p2_value(&m_rms_p50));
+    p_snap->rms_p90       = to_u16(emg_p2_value(&m_rms_p90));
+    p_snap->rms_windows   = (m_rms_windows > UINT16_MAX) ? UINT16_MAX : (uint16_t)m_rms_windows;
+}
+
+bool emg_stats_push(int16_t sample, bool active, emg_stats_snapshot_t * p_snap)
+{
+    int32_t x = sample;
+    float amp = (float)((x < 0) ? -x : x);
+
+    m_samples++;
+    if (active) {
+        m_active_samples++;
+    }
+
+    emg_p2_push(&m_amp_p50, amp);
+    emg_p2_push(&m_amp_p90, amp);
+    emg_p2_push(&m_amp_p99, amp);
+
+    m_rms_acc += (uint64_t)((int64_t)x * x);
+    if (++m_rms_fill >= EMG_STATS_RMS_WINDOW) {
+        float rms = sqrtf((float)m_rms_acc / (float)EMG_STATS_RMS_WINDOW);
+        emg_p2_push(&m_rms_p10, rms);
+        emg_p2_push(&m_rms_p50, rms);
+        emg_p2_push(&m_rms_p90, rms);
+        m_rms_windows++;
+        m_rms_acc = 0;
+        m_rms_fill = 0;
+    }
+
+    if (++m_publish_count < EMG_STATS_PUBLISH_SAMPLES) {
+        return false;
+    }
+    m_publish_count = 0;
+    emg_stats_snapshot(p_snap);
+    return true;
+}
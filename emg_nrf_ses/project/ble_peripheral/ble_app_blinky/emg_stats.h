@@ -0,0 +1,50 @@
+#ifndef EMG_STATS_H__
+#define EMG_STATS_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Estatísticas de sessão em memória O(1), legíveis a qualquer momento:
+//   - percentis da amplitude |x| do sinal filtrado (P², Jain & Chlamtac)
+//   - percentis do RMS em janelas de 100 ms
+//   - duty cycle de ativação (detector de onset/offset)
+#define EMG_STATS_RMS_WINDOW          100     // Amostras por janela de RMS (100 ms @ 1kSPS)
+#define EMG_STATS_PUBLISH_SAMPLES     1000    // Snapshot a cada 1 s
+#define EMG_STATS_CMD_RESET           0x01    // Escrita na característica: inicia nova sessão
+
+// Estimador P² de um quantil: 5 marcadores, sem armazenar amostras
+typedef struct {
+    float    p;               // Quantil alvo (0..1)
+    float    q[5];            // Alturas dos marcadores
+    int32_t  n[5];            // Posições atuais
+    float    d[5];            // Posição desejada - posição atual
+    uint32_t count;
+} emg_p2_t;
+
+void  emg_p2_init(emg_p2_t * p_est, float p);
+void  emg_p2_push(emg_p2_t * p_est, float x);
+float emg_p2_value(emg_p2_t const * p_est);
+
+// Snapshot da característica de estatísticas (20 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint32_t samples;         // Amostras desde o início da sessão
+    uint16_t duty_permille;   // Fração do tempo com músculo ativo (0.1 %)
+    uint16_t amp_p50;         // Percentis de |x| em contagens do ADC
+    uint16_t amp_p90;
+    uint16_t amp_p99;
+    uint16_t rms_p10;         // Percentis do RMS de 100 ms em contagens
+    uint16_t rms_p50;
+    uint16_t rms_p90;
+    uint16_t rms_windows;     // Janelas de RMS acumuladas (satura em 65535)
+} emg_stats_snapshot_t;
+
+// Zera a sessão
+void emg_stats_init(void);
+
+// Acumula uma amostra filtrada e o estado do detector de ativação.
+// Retorna true a cada EMG_STATS_PUBLISH_SAMPLES com p_snap preenchido.
+bool emg_stats_push(int16_t sample, bool active, emg_stats_snapshot_t * p_snap);
+
+void emg_stats_snapshot(emg_stats_snapshot_t * p_snap);
+
+#endif // EMG_STATS_H__
@@ -0,0 +1,211 @@
+#include "emg_store.h"
+#include "emg_platform.h"
+
+#define STORE_MASK      (EMG_STORE_FRAMES - 1)
+
+EMG_STATIC_ASSERT((EMG_STORE_FRAMES & STORE_MASK) == 0 && EMG_STORE_FRAMES <= 32768);
+
+static emg_store_frame_t m_frames[EMG_STORE_FRAMES];
+
+// Lado do produtor
+static volatile uint32_t m_head;                          // Frames publicados
+static uint32_t          m_reserved;                      // Frames com parte bruta escrita
+static volatile uint32_t m_overflows[EMG_STORE_VIEW_COUNT];
+static volatile uint16_t m_high_water[EMG_STORE_VIEW_COUNT];
+
+// Saltos do índice de amostra: frame a partir do qual vale cada base
+typedef struct {
+    uint32_t frame;
+    uint32_t sample;
+} store_mark_t;
+
+static store_mark_t      m_marks[EMG_STORE_INDEX_MARKS];
+static volatile uint32_t m_mark_count;                    // Marcas escritas desde o boot
+
+// Lado de cada consumidor
+static volatile uint32_t m_tail[EMG_STORE_VIEW_COUNT];
+static volatile bool     m_active[EMG_STORE_VIEW_COUNT];
+
+void emg_store_init(void)
+{
+    m_head = 0;
+    m_reserved = 0;
+    m_mark_count = 0;
+    for (uint8_t v = 0; v < EMG_STORE_VIEW_COUNT; v++) {
+        m_tail[v] = 0;
+        m_active[v] = false;
+        m_overflows[v] = 0;
+        m_high_water[v] = 0;
+    }
+}
+
+// Nova base quando o bloco não continua o anterior (frames descartados ou aquisição parada)
+static void mark_index(uint32_t head, uint32_t first_index)
+{
+    uint32_t count = m_mark_count;
+    if (count > 0) {
+        store_mark_t const * p_last = &m_marks[(count - 1) % EMG_STORE_INDEX_MARKS];
+        if (p_last->sample + (head - p_last->frame) == first_index) {
+            return;
+        }
+    }
+    m_marks[count % EMG_STORE_INDEX_MARKS].frame  = head;
+    m_marks[count % EMG_STORE_INDEX_MARKS].sample = first_index;
+    // Marca completa antes de ser visível para as views
+    EMG_PLATFORM_DMB();
+    m_mark_count = count + 1;
+}
+
+uint16_t emg_store_write_raw(int16_t const * p_raw, uint16_t n, uint32_t first_index)
+{
+    uint32_t head = m_head;
+
+    // Espaço livre limitado pela view ativa mais atrasada
+    uint32_t room = EMG_STORE_FRAMES;
+    for (uint8_t v = 0; v < EMG_STORE_VIEW_COUNT; v++) {
+        if (m_active[v]) {
+            uint32_t space = EMG_STORE_FRAMES - (head - m_tail[v]);
+            if (space < room) {
+                room = space;
+            }
+        }
+    }
+    // Tails lidos antes de sobrescrever os frames que eles liberaram
+    EMG_PLATFORM_DMB();
+
+    if (n > room) {
+        for (uint8_t v = 0; v < EMG_STORE_VIEW_COUNT; v++) {
+            if (m_active[v]) {
+                m_overflows[v] += n - room;
+            }
+        }
+        n = (uint16_t)room;
+    }
+
+    if (n > 0) {
+        mark_index(head, first_index);
+    }
+    for (uint16_t i = 0; i < n; i++) {
+        m_frames[(head + i) & STORE_MASK].raw = p_raw[i];
+    }
+    m_reserved = head + n;
+    return n;
+}
+
+void emg_store_write_filtered(int16_t const * p_filtered, uint16_t n)
+{
+    uint32_t head    = m_head;
+    uint32_t pending = m_reserved - head;
+    if (n > pending) {
+        n = (uint16_t)pending;
+    }
+    for (uint16_t i = 0; i < n; i++) {
+        m_frames[(head + i) & STORE_MASK].filtered = p_filtered[i];
+    }
+
+    // Frames completos antes de ficarem visíveis para as views
+    EMG_PLATFORM_DMB();
+    head += n;
+    m_head = head;
+
+    for (uint8_t v = 0; v < EMG_STORE_VIEW_COUNT; v++) {
+        if (m_active[v]) {
+            uint16_t level = (uint16_t)(head - m_tail[v]);
+            if (level > m_high_water[v]) {
+                m_high_water[v] = level;
+            }
+        }
+    }
+}
+
+void emg_store_set_active(emg_store_view_t view, bool active)
+{
+    if (active && !m_active[view]) {
+        m_tail[view] = m_head;
+        EMG_PLATFORM_DMB();
+    }
+    m_active[view] = active;
+}
+
+bool emg_store_any_active(void)
+{
+    for (uint8_t v = 0; v < EMG_STORE_VIEW_COUNT; v++) {
+        if (m_active[v]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint16_t emg_store_available(emg_store_view_t view)
+{
+    if (!m_active[view]) {
+        return 0;
+    }
+    uint16_t avail = (uint16_t)(m_head - m_tail[view]);
+    // Índice lido antes dos frames que ele publica
+    EMG_PLATFORM_DMB();
+    return avail;
+}
+
+uint16_t emg_store_peek(emg_store_view_t view, uint16_t offset,
+                        emg_store_frame_t const ** pp_frames, uint16_t max)
+{
+    uint16_t avail = emg_store_available(view);
+    if (offset >= avail) {
+        return 0;
+    }
+    avail -= offset;
+
+    uint32_t start = (m_tail[view] + offset) & STORE_MASK;
+    uint16_t span  = (uint16_t)(EMG_STORE_FRAMES - start);     // Até o fim do ring
+    if (span > avail) span = avail;
+    if (span > max)   span = max;
+
+    *pp_frames = &m_frames[start];
+    return span;
+}
+
+uint32_t emg_store_sample_index(emg_store_view_t view, uint16_t offset)
+{
+    uint32_t frame = m_tail[view] + offset;
+    uint32_t count = m_mark_count;
+    EMG_PLATFORM_DMB();
+
+    // Marca mais recente que cobre o frame (quase sempre a última)
+    uint32_t oldest = (count > EMG_STORE_INDEX_MARKS) ? count - EMG_STORE_INDEX_MARKS : 0;
+    store_mark_t const * p_mark = NULL;
+    for (uint32_t i = count; i > oldest; i--) {
+        p_mark = &m_marks[(i - 1) % EMG_STORE_INDEX_MARKS];
+        if ((int32_t)(frame - p_mark->frame) >= 0) {
+            break;
+        }
+    }
+    if (p_mark == NULL) {
+        return frame;
+    }
+    return p_mark->sample + (frame - p_mark->frame);
+}
+
+void emg_store_consume(emg_store_view_t view, uint16_t n)
+{
+    uint16_t avail = emg_store_available(view);
+    // Leitura dos frames concluída antes de liberá-los ao produtor
+    EMG_PLATFORM_DMB();
+    m_tail[view] += (n > avail) ? avail : n;
+}
+
+uint32_t emg_store_overruns(emg_store_view_t view)
+{
+    return m_overflows[view];
+}
+
+void emg_store_get_stats(emg_store_stats_t * p_stats)
+{
+    p_stats->depth = EMG_STORE_FRAMES;
+    for (uint8_t v = 0; v < EMG_STORE_VIEW_COUNT; v++) {
+        p_stats->views[v].overflows      = m_overflows[v];
+        p_stats->views[v].high_watermark = m_high_water[v];
+        p_stats->views[v].level          = emg_store_available((emg_store_view_t)v);
+    }
+}
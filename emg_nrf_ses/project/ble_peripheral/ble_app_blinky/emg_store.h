@@ -0,0 +1,82 @@
+#ifndef EMG_STORE_H__
+#define EMG_STORE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Store único de amostras na taxa de aquisição: cada frame guarda a amostra
+// bruta do ADC e a filtrada. Cada stream lê por uma view (cursor próprio)
+// que aponta direto para o ring, sem cópia intermediária. Views inativas
+// (stream sem inscrição) não seguram espaço e começam do zero ao ligar.
+//
+// Ring SPSC sem lock: o produtor (pipeline, pode rodar em IRQ) só escreve
+// head/contadores, cada consumidor (loop principal) só escreve o próprio
+// tail; a ordem frames → índice é garantida por barreiras (DMB). Ring cheio
+// não sobrescreve frames ainda não lidos: os novos são descartados e contados.
+#ifndef EMG_STORE_FRAMES
+#define EMG_STORE_FRAMES              4096    // Potência de 2, <= 32768 (~4 s @ 1kSPS, 16 KB)
+#endif
+
+// Saltos do índice de amostra (overflow, aquisição parada) lembrados para
+// resolver o índice de cada frame; mais saltos que isso dentro do ring
+// deixam os frames mais antigos com o índice aproximado
+#define EMG_STORE_INDEX_MARKS         8
+
+typedef struct {
+    int16_t raw;
+    int16_t filtered;
+} emg_store_frame_t;
+
+typedef enum {
+    EMG_STORE_VIEW_FILTERED = 0,
+    EMG_STORE_VIEW_RAW,
+    EMG_STORE_VIEW_COUNT
+} emg_store_view_t;
+
+// Contadores de uma view desde o boot (8 bytes, little-endian)
+typedef struct __attribute__((packed)) {
+    uint32_t overflows;               // Frames perdidos com o ring cheio
+    uint16_t high_watermark;          // Maior ocupação vista (frames)
+    uint16_t level;                   // Ocupação atual (frames)
+} emg_store_view_stats_t;
+
+// Valor da característica Store Stats (2 + 8 * views bytes)
+typedef struct __attribute__((packed)) {
+    uint16_t               depth;     // EMG_STORE_FRAMES
+    emg_store_view_stats_t views[EMG_STORE_VIEW_COUNT];
+} emg_store_stats_t;
+
+void emg_store_init(void);
+
+// Escrita em blocos em duas fases pelo pipeline: a parte bruta reserva os
+// frames, a filtrada completa os mesmos frames e os publica para as views.
+// first_index = índice absoluto da primeira amostra do bloco (na taxa de aquisição).
+// Retorna quantos frames couberam (o restante do bloco é descartado e contado).
+uint16_t emg_store_write_raw(int16_t const * p_raw, uint16_t n, uint32_t first_index);
+void emg_store_write_filtered(int16_t const * p_filtered, uint16_t n);
+
+// Liga/desliga uma view (só pelo consumidor). Ao ligar, começa nos próximos frames publicados.
+void emg_store_set_active(emg_store_view_t view, bool active);
+
+bool emg_store_any_active(void);
+
+// Frames publicados ainda não consumidos pela view (0 se inativa)
+uint16_t emg_store_available(emg_store_view_t view);
+
+// Trecho contíguo de até max frames a partir do cursor da view (sem consumir).
+// offset pula frames já vistos. Retorna o tamanho do trecho.
+uint16_t emg_store_peek(emg_store_view_t view, uint16_t offset,
+                        emg_store_frame_t const ** pp_frames, uint16_t max);
+
+// Índice absoluto da amostra do frame em cursor + offset (timestamp dos pacotes)
+uint32_t emg_store_sample_index(emg_store_view_t view, uint16_t offset);
+
+// Libera n frames da view para o produtor (leitura dos frames concluída)
+void emg_store_consume(emg_store_view_t view, uint16_t n);
+
+// Frames perdidos pela view com o ring cheio
+uint32_t emg_store_overruns(emg_store_view_t view);
+
+void emg_store_get_stats(emg_store_stats_t * p_stats);
+
+#endif // EMG_STORE_H__
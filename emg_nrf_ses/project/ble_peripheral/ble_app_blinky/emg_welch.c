@@ -0,0 +1,145 @@
+#include "emg_welch.h"
+#include "emg_config.h"
+#include "emg_fft.h"
+#include <math.h>
+#include <string.h>
+
+#define PI_F 3.14159265358979f
+
+#define BLOCK_SAMPLES EMG_SAMPLE_RATE_HZ          // Passo da janela deslizante (1 s)
+
+static emg_rfft_t m_fft;
+static uint16_t   m_len;
+static uint16_t   m_hop;
+static uint8_t    m_blocks;                       // Blocos na janela (segundos)
+static float      m_window[EMG_WELCH_MAX_LEN];
+static float      m_work[EMG_WELCH_MAX_LEN];
+static int16_t    m_frame[EMG_WELCH_MAX_LEN];
+static float      m_acc[EMG_WELCH_MAX_SECONDS][EMG_WELCH_MAX_BINS];  // Soma de |X|² por bloco
+static uint8_t    m_block_segments[EMG_WELCH_MAX_SECONDS];
+static uint8_t    m_block;                        // Bloco em acumulação
+static uint8_t    m_blocks_done;                  // Blocos completos (satura em m_blocks)
+static uint16_t   m_block_fill;                   // Amostras no bloco atual
+static uint16_t   m_fill;
+static uint16_t   m_snapshot_seq;
+static float      m_psd_scale;                    // 1 / (fs * sum(w²))
+
+bool emg_welch_configure(uint8_t seg_len_log2, uint8_t seconds)
+{
+    if (seg_len_log2 < EMG_WELCH_MIN_LOG2 || seg_len_log2 > EMG_WELCH_MAX_LOG2 ||
+        seconds < 1 || seconds > EMG_WELCH_MAX_SECONDS) {
+        return false;
+    }
+
+    // Pior caso de segmentos na janela (um a mais pelo alinhamento dos blocos)
+    uint16_t hop = (uint16_t)(1u << (seg_len_log2 - 1));
+    uint32_t segments = ((uint32_t)seconds * BLOCK_SAMPLES + hop - 1) / hop + 1;
+    if (segments > UINT8_MAX) {
+        return false;
+    }
+
+    m_len    = (uint16_t)(1u << seg_len_log2);
+    m_hop    = hop;
+    m_blocks = seconds;
+
+    float w_energy = 0.0f;
+    for (uint16_t i = 0; i < m_len; i++) {
+        m_window[i] = 0.5f - 0.5f * cosf(2.0f * PI_F * (float)i / (float)m_len);
+        w_energy += m_window[i] * m_window[i];
+    }
+    m_psd_scale = 1.0f / ((float)EMG_SAMPLE_RATE_HZ * w_energy);
+
+    emg_rfft_init(&m_fft, m_len);
+    memset(m_acc, 0, sizeof(m_acc));
+    memset(m_block_segments, 0, sizeof(m_block_segments));
+    m_block       = 0;
+    m_blocks_done = 0;
+    m_block_fill  = 0;
+    m_fill        = 0;
+    return true;
+}
+
+void emg_welch_init(void)
+{
+    m_snapshot_seq = 0;
+    emg_welch_configure(EMG_WELCH_DEFAULT_LOG2, EMG_WELCH_DEFAULT_SECONDS);
+}
+
+static void accumulate_segment(void)
+{
+    for (uint16_t i = 0; i < m_len; i++) {
+        m_work[i] = (float)m_frame[i] * m_window[i];
+    }
+    emg_rfft(&m_fft, m_work);
+
+    float *  p_acc = m_acc[m_block];
+    uint16_t half  = m_len / 2;
+    p_acc[0]    += m_work[0] * m_work[0];
+    p_acc[half] += m_work[1] * m_work[1];
+    for (uint16_t k = 1; k < half; k++) {
+        p_acc[k] += m_work[2 * k] * m_work[2 * k] + m_work[2 * k + 1] * m_work[2 * k + 1];
+    }
+    m_block_segments[m_block]++;
+}
+
+// Média dos blocos da janela (o atual acabou de fechar)
+static uint16_t build_snapshot(emg_welch_snapshot_t * p_snap)
+{
+    uint16_t half     = m_len / 2;
+    uint16_t n_bins   = half + 1;
+    uint16_t segments = 0;
+
+    for (uint8_t b = 0; b < m_blocks; b++) {
+        segments += m_block_segments[b];
+    }
+    float scale = (segments > 0) ? m_psd_scale / (float)segments : 0.0f;
+
+    for (uint16_t k = 0; k < n_bins; k++) {
+        float acc = 0.0f;
+        for (uint8_t b = 0; b < m_blocks; b++) {
+            acc += m_acc[b][k];
+        }
+        // Unilateral: bins internos contam a energia das frequências negativas
+        float psd = acc * scale * ((k == 0 || k == half) ? 1.0f : 2.0f);
+        float db2 = (psd > 1.0f) ? 20.0f * log10f(psd) : 0.0f;
+        p_snap->psd_db_x2[k] = (uint8_t)((db2 > 255.0f) ? 255.0f : db2 + 0.5f);
+    }
+
+    p_snap->snapshot_seq = m_snapshot_seq++;
+    p_snap->bin_hz_x100  = (uint16_t)((100u * EMG_SAMPLE_RATE_HZ + m_len / 2) / m_len);
+    p_snap->n_bins       = (uint8_t)n_bins;
+    p_snap->n_segments   = (uint8_t)segments;     // <= 255 garantido no configure
+
+    return (uint16_t)(EMG_WELCH_HEADER_LEN + n_bins);
+}
+
+bool emg_welch_push(int16_t sample, emg_welch_snapshot_t * p_snap, uint16_t * p_len)
+{
+    m_frame[m_fill++] = sample;
+    if (m_fill == m_len) {
+        // Segmento conta no bloco em que termina
+        accumulate_segment();
+        memmove(m_frame, &m_frame[m_hop], (m_len - m_hop) * sizeof(int16_t));
+        m_fill = m_len - m_hop;
+    }
+
+    if (++m_block_fill < BLOCK_SAMPLES) {
+        return false;
+    }
+    m_block_fill = 0;
+    if (m_blocks_done < m_blocks) {
+        m_blocks_done++;
+    }
+
+    // Primeira publicação só com a janela cheia; depois, uma por segundo
+    bool ready = (m_blocks_done == m_blocks);
+    if (ready) {
+        *p_len = build_snapshot(p_snap);
+    }
+
+    // Bloco mais antigo sai da janela e passa a acumular o próximo segundo
+    m_block = (uint8_t)((m_block + 1) % m_blocks);
+    memset(m_acc[m_block], 0, sizeof(m_acc[m_block]));
+    m_block_segments[m_block] = 0;
+    return ready;
+}
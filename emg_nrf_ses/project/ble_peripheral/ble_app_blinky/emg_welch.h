@@ -0,0 +1,42 @@
+#ifndef EMG_WELCH_H__
+#define EMG_WELCH_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// Estimativa de PSD por Welch sobre o sinal filtrado: segmentos Hann com
+// 50% de sobreposição, acumulados incrementalmente a cada hop em blocos de
+// 1 s. A cada segundo o snapshot soma os últimos N blocos (janela deslizante
+// de N segundos, passo de 1 s) e o bloco mais antigo sai da soma.
+#define EMG_WELCH_MIN_LOG2            6       // 64 pontos  (15.6 Hz @ 1kSPS)
+#define EMG_WELCH_MAX_LOG2            8       // 256 pontos (3.9 Hz @ 1kSPS)
+#define EMG_WELCH_MAX_LEN             (1 << EMG_WELCH_MAX_LOG2)
+#define EMG_WELCH_MAX_BINS            (EMG_WELCH_MAX_LEN / 2 + 1)
+
+#define EMG_WELCH_DEFAULT_LOG2        8
+#define EMG_WELCH_DEFAULT_SECONDS     1
+#define EMG_WELCH_MAX_SECONDS         10      // Blocos guardados: 10 x 129 floats (~5 KB)
+
+// Snapshot enviado pela característica de PSD (6 + n_bins bytes)
+typedef struct __attribute__((packed)) {
+    uint16_t snapshot_seq;
+    uint16_t bin_hz_x100;                     // Resolução em centésimos de Hz
+    uint8_t  n_bins;                          // DC .. Nyquist
+    uint8_t  n_segments;                      // Segmentos promediados
+    uint8_t  psd_db_x2[EMG_WELCH_MAX_BINS];   // 10*log10(contagens²/Hz) em passos de 0.5 dB
+} emg_welch_snapshot_t;
+
+#define EMG_WELCH_HEADER_LEN          6
+
+void emg_welch_init(void);
+
+// seg_len_log2: EMG_WELCH_MIN_LOG2..EMG_WELCH_MAX_LOG2; seconds: 1..EMG_WELCH_MAX_SECONDS,
+// com no máximo 255 segmentos na janela (n_segments do snapshot; 64 pontos
+// vão até 8 s). Descarta a média em andamento. Retorna false se inválido.
+bool emg_welch_configure(uint8_t seg_len_log2, uint8_t seconds);
+
+// Processa uma amostra. Retorna true quando p_snap foi preenchido;
+// *p_len recebe o tamanho útil do snapshot em bytes.
+bool emg_welch_push(int16_t sample, emg_welch_snapshot_t * p_snap, uint16_t * p_len);
+
+#endif // EMG_WELCH_H__
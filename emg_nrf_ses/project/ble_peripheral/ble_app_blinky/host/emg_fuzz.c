@@ -0,0 +1,191 @@
+/*
+ * Alvo de fuzzing dos parsers que recebem bytes de fora: decodificador do
+ * codec (pacotes do stream comprimido) e blob do modelo do classificador
+ * (escritas BLE em staging + commit). O primeiro byte escolhe o alvo.
+ *
+ *   make fuzz                     # libFuzzer (clang), corpus em fuzz_corpus/
+ *   make fuzz-smoke               # sem clang: entradas mutadas a partir do encoder
+ *   ./emg_fuzz_replay arquivo...  # reproduz um crash (também alvo do AFL: @@)
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "emg_codec.h"
+#include "emg_classifier.h"
+#include "emg_features.h"
+
+enum {
+    TARGET_CODEC = 0,
+    TARGET_MODEL,
+    TARGET_COUNT
+};
+
+void emg_host_log(char const * p_level, char const * p_fmt, ...)
+{
+    (void)p_level;
+    (void)p_fmt;
+}
+
+// Pacote no tamanho exato recebido: leitura além de len cai no ASan
+static void fuzz_codec(uint8_t const * p_data, size_t size)
+{
+    if (size > sizeof(emg_codec_packet_t)) {
+        size = sizeof(emg_codec_packet_t);
+    }
+    uint8_t * p_buf = malloc(size ? size : 1);
+    memcpy(p_buf, p_data, size);
+
+    int16_t out[EMG_CODEC_MAX_SAMPLES];
+    uint8_t n = emg_codec_decode((emg_codec_packet_t const *)p_buf, (uint16_t)size, out);
+    free(p_buf);
+    if (n == 0) {
+        return;
+    }
+    if (n > EMG_CODEC_MAX_SAMPLES) {
+        abort();
+    }
+
+    // O que decodifica precisa voltar igual por uma ida e volta sem perda
+    if ((n % 4) == 0) {
+        emg_codec_packet_t pkt;
+        int16_t again[EMG_CODEC_MAX_SAMPLES];
+        uint16_t len = emg_codec_encode(out, n, 0, 0, &pkt);
+        if (emg_codec_decode(&pkt, len, again) != n || memcmp(out, again, n * sizeof(int16_t)) != 0) {
+            abort();
+        }
+    }
+}
+
+// Blob em trechos como nas escritas BLE; modelo aceito precisa inferir
+static void fuzz_model(uint8_t const * p_data, size_t size)
+{
+    if (size > EMG_CLF_MODEL_MAX_LEN) {
+        size = EMG_CLF_MODEL_MAX_LEN;
+    }
+    emg_classifier_init();
+    for (size_t offset = 0; offset < size; offset += 20) {
+        size_t chunk = (size - offset < 20) ? size - offset : 20;
+        if (!emg_classifier_stage((uint16_t)offset, &p_data[offset], (uint16_t)chunk)) {
+            abort();
+        }
+    }
+    if (!emg_classifier_commit((uint16_t)size, EMG_FEAT_COUNT)) {
+        return;
+    }
+
+    float   features[EMG_FEAT_COUNT];
+    uint8_t class_id;
+    for (uint8_t i = 0; i < EMG_FEAT_COUNT; i++) {
+        features[i] = (float)(i + 1) * 0.25f;
+    }
+    if (!emg_classifier_infer(features, &class_id)) {
+        abort();
+    }
+    emg_classifier_status_t status;
+    emg_classifier_status(&status);
+    if (class_id >= status.n_classes) {
+        abort();
+    }
+}
+
+int LLVMFuzzerTestOneInput(uint8_t const * p_data, size_t size)
+{
+    if (size == 0) {
+        return 0;
+    }
+    switch (p_data[0] % TARGET_COUNT) {
+    case TARGET_CODEC: fuzz_codec(&p_data[1], size - 1); break;
+    default:           fuzz_model(&p_data[1], size - 1); break;
+    }
+    return 0;
+}
+
+#ifndef EMG_FUZZ_LIBFUZZER
+// Sem libFuzzer: reproduz arquivos (ou stdin) ou gera -r N entradas mutadas
+#define MAX_INPUT           1024
+
+static uint32_t m_rng = 0x9E3779B9u;
+
+static uint32_t rng_next(void)
+{
+    m_rng ^= m_rng << 13;
+    m_rng ^= m_rng >> 17;
+    m_rng ^= m_rng << 5;
+    return m_rng;
+}
+
+static size_t read_input(FILE * p_file, uint8_t * p_buf)
+{
+    return fread(p_buf, 1, MAX_INPUT, p_file);
+}
+
+// Pacote válido do encoder (ou blob LDA válido) com bytes trocados e cortes
+static size_t mutated_input(uint8_t * p_buf)
+{
+    size_t size;
+    if (rng_next() & 1) {
+        int16_t x[EMG_CODEC_MAX_SAMPLES];
+        for (uint8_t i = 0; i < EMG_CODEC_MAX_SAMPLES; i++) {
+            x[i] = (int16_t)((rng_next() % 2001) - 1000);
+        }
+        emg_codec_packet_t pkt;
+        uint8_t n = (uint8_t)(4 * (1 + rng_next() % (EMG_CODEC_MAX_SAMPLES / 4)));
+        size = 1 + emg_codec_encode(x, n, (uint16_t)(rng_next() % 64), 0, &pkt);
+        p_buf[0] = TARGET_CODEC;
+        memcpy(&p_buf[1], &pkt, size - 1);
+    } else {
+        uint8_t f = EMG_FEAT_COUNT, c = 2 + rng_next() % (EMG_CLF_MAX_CLASSES - 1);
+        size = 0;
+        p_buf[size++] = TARGET_MODEL;
+        p_buf[size++] = EMG_CLF_MODEL_LDA;
+        p_buf[size++] = f;
+        p_buf[size++] = c;
+        p_buf[size++] = 0;
+        for (uint16_t i = 0; i < (2 + c) * f + c; i++) {
+            float v = (float)((int32_t)(rng_next() % 2001) - 1000) / 100.0f;
+            memcpy(&p_buf[size], &v, sizeof(v));
+            size += sizeof(v);
+        }
+    }
+
+    for (uint32_t flips = rng_next() % 4; flips > 0; flips--) {
+        p_buf[1 + rng_next() % (size - 1)] ^= (uint8_t)(1u << (rng_next() % 8));
+    }
+    if ((rng_next() % 4) == 0) {
+        size = 1 + rng_next() % size;
+    }
+    return size;
+}
+
+int main(int argc, char ** argv)
+{
+    static uint8_t buf[MAX_INPUT];
+
+    if (argc == 3 && strcmp(argv[1], "-r") == 0) {
+        uint32_t runs = (uint32_t)strtoul(argv[2], NULL, 0);
+        for (uint32_t i = 0; i < runs; i++) {
+            size_t size = mutated_input(buf);
+            (void)LLVMFuzzerTestOneInput(buf, size);
+        }
+        printf("fuzz: %u mutated inputs, no crash\n", runs);
+        return 0;
+    }
+    if (argc == 1) {
+        return LLVMFuzzerTestOneInput(buf, read_input(stdin, buf));
+    }
+    for (int i = 1; i < argc; i++) {
+        FILE * p_file = fopen(argv[i], "rb");
+        if (p_file == NULL) {
+            perror(argv[i]);
+            return 1;
+        }
+        size_t size = read_input(p_file, buf);
+        fclose(p_file);
+        (void)LLVMFuzzerTestOneInput(buf, size);
+    }
+    return 0;
+}
+#endif
@@ -0,0 +1,265 @@
+/*
+ * Build de host do núcleo de DSP (emg_core.c + módulos emg_*).
+ * Reproduz um CSV gravado (CSVs de processData, uma amostra por linha) ou um
+ * sinal sintético pelo mesmo pipeline do firmware e mede a vazão no PC.
+ * As chamadas de barramento e rádio do alvo viram stubs que só contam eventos.
+ *
+ *   make && ./emg_host -n 100 ../../../../../processData/triceps_5s_1.csv
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "emg_core.h"
+#include "emg_config.h"
+#include "emg_pipeline.h"
+#include "emg_store.h"
+#include "emg_decimator.h"
+#include "emg_adaptive.h"
+
+#define SYNTH_SECONDS       10
+
+static bool     m_verbose;
+static uint32_t m_activations;
+static uint32_t m_fatigue_windows;
+static uint32_t m_psd_windows;
+static uint32_t m_class_changes;
+static uint8_t  m_wiper = 0xFF;
+
+void emg_host_log(char const * p_level, char const * p_fmt, ...)
+{
+    if (!m_verbose) {
+        return;
+    }
+    va_list args;
+    va_start(args, p_fmt);
+    fprintf(stderr, "<%s> ", p_level);
+    vfprintf(stderr, p_fmt, args);
+    fputc('\n', stderr);
+    va_end(args);
+}
+
+// === Stubs do alvo (DS3502 e serviço BLE) ===
+static bool host_gain_write(uint8_t wiper)
+{
+    m_wiper = wiper;
+    return true;
+}
+
+static void host_activation(emg_activation_evt_t const * p_evt)
+{
+    m_activations++;
+}
+
+static void host_fatigue(emg_fatigue_metrics_t const * p_metrics)
+{
+    m_fatigue_windows++;
+    emg_host_log("info", "Fatigue #%u: MNF %.1f Hz, MDF %.1f Hz", p_metrics->window_seq,
+                 p_metrics->mnf_dhz / 10.0, p_metrics->mdf_dhz / 10.0);
+}
+
+static void host_psd(emg_welch_snapshot_t const * p_snapshot, uint16_t len)
+{
+    m_psd_windows++;
+}
+
+static void host_class_changed(uint8_t class_id)
+{
+    m_class_changes++;
+}
+
+static bool host_fatigue_subscribed(void)
+{
+    return true;
+}
+
+static const emg_core_platform_t m_host_platform = {
+    .gain_write         = host_gain_write,
+    .activation         = host_activation,
+    .fatigue            = host_fatigue,
+    .psd                = host_psd,
+    .class_changed      = host_class_changed,
+    .fatigue_subscribed = host_fatigue_subscribed,
+};
+
+// === Entrada ===
+// Primeira coluna numérica de cada linha; cabeçalho e linhas vazias são pulados
+static int16_t * load_csv(char const * p_path, uint32_t * p_count)
+{
+    FILE * p_file = fopen(p_path, "r");
+    if (p_file == NULL) {
+        return NULL;
+    }
+    uint32_t cap = 4096, n = 0;
+    int16_t * p_samples = malloc(cap * sizeof(int16_t));
+    char line[128];
+    while (p_samples != NULL && fgets(line, sizeof(line), p_file) != NULL) {
+        char * p_end;
+        long value = strtol(line, &p_end, 10);
+        if (p_end == line) {
+            continue;
+        }
+        if (n == cap) {
+            cap *= 2;
+            int16_t * p_grown = realloc(p_samples, cap * sizeof(int16_t));
+            if (p_grown == NULL) {
+                free(p_samples);
+                p_samples = NULL;
+                break;
+            }
+            p_samples = p_grown;
+        }
+        p_samples[n++] = (int16_t)(value > INT16_MAX ? INT16_MAX : (value < INT16_MIN ? INT16_MIN : value));
+    }
+    fclose(p_file);
+    *p_count = n;
+    return p_samples;
+}
+
+// Contrações de 1 s a cada 2 s sobre ruído de base, com 60 Hz e deriva de offset
+static int16_t * synth_signal(uint32_t * p_count)
+{
+    uint32_t n = SYNTH_SECONDS * EMG_SAMPLE_RATE_HZ;
+    int16_t * p_samples = malloc(n * sizeof(int16_t));
+    if (p_samples == NULL) {
+        return NULL;
+    }
+    srand(1);
+    for (uint32_t i = 0; i < n; i++) {
+        double t     = (double)i / EMG_SAMPLE_RATE_HZ;
+        double noise = (double)rand() / RAND_MAX - 0.5;
+        double amp   = (fmod(t, 2.0) >= 1.0) ? 2000.0 : 40.0;
+        double x     = 500.0 + 200.0 * sin(2.0 * M_PI * 0.2 * t)
+                     + 100.0 * sin(2.0 * M_PI * 60.0 * t) + amp * noise;
+        p_samples[i] = (int16_t)x;
+    }
+    *p_count = n;
+    return p_samples;
+}
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static void usage(char const * p_name)
+{
+    fprintf(stderr,
+            "usage: %s [-n repeats] [-r rate_hz] [-a] [-o stream.csv] [-v] [file.csv]\n"
+            "  -n  reproduz o sinal n vezes (benchmark)\n"
+            "  -r  taxa de saída do stream filtrado (decimação)\n"
+            "  -a  liga a taxa adaptativa\n"
+            "  -o  grava o stream filtrado (uma amostra por linha)\n"
+            "  -v  log dos módulos e métricas por janela\n"
+            "Sem arquivo: %d s de sinal sintético.\n", p_name, SYNTH_SECONDS);
+}
+
+int main(int argc, char ** argv)
+{
+    uint32_t repeats  = 1;
+    uint16_t rate_hz  = EMG_SAMPLE_RATE_HZ;
+    bool     adaptive = false;
+    char const * p_out_path = NULL;
+
+    int opt;
+    while ((opt = getopt(argc, argv, "n:r:ao:vh")) != -1) {
+        switch (opt) {
+            case 'n': repeats  = (uint32_t)strtoul(optarg, NULL, 10); break;
+            case 'r': rate_hz  = (uint16_t)strtoul(optarg, NULL, 10); break;
+            case 'a': adaptive = true;                                break;
+            case 'o': p_out_path = optarg;                            break;
+            case 'v': m_verbose = true;                               break;
+            default:  usage(argv[0]); return (opt == 'h') ? 0 : 2;
+        }
+    }
+
+    uint32_t count;
+    int16_t * p_samples = (optind < argc) ? load_csv(argv[optind], &count) : synth_signal(&count);
+    if (p_samples == NULL || count < EMG_PIPELINE_BLOCK_LEN) {
+        fprintf(stderr, "no samples\n");
+        return 1;
+    }
+
+    FILE * p_out = NULL;
+    if (p_out_path != NULL && (p_out = fopen(p_out_path, "w")) == NULL) {
+        perror(p_out_path);
+        return 1;
+    }
+
+    if (!emg_core_init(&m_host_platform) || !emg_decimator_select(rate_hz)) {
+        fprintf(stderr, "init failed (rate %u Hz)\n", rate_hz);
+        return 1;
+    }
+    (void)emg_core_set_gain(EMG_GAIN_LEVEL_MIN);
+    emg_adaptive_enable(adaptive);
+    emg_store_set_active(EMG_STORE_VIEW_FILTERED, true);
+
+    uint8_t  n_stages = emg_pipeline_stage_count();
+    uint64_t stage_ns[EMG_PIPELINE_MAX_STAGES] = { 0 };
+    uint64_t stage_samples[EMG_PIPELINE_MAX_STAGES] = { 0 };
+    emg_stage_stats_t stats[EMG_PIPELINE_MAX_STAGES];
+
+    uint32_t blocks = count / EMG_PIPELINE_BLOCK_LEN;
+    uint64_t index  = 0;
+    uint64_t streamed = 0;
+    int16_t  block[EMG_PIPELINE_BLOCK_LEN];
+
+    double start = now_s();
+    for (uint32_t r = 0; r < repeats; r++) {
+        for (uint32_t b = 0; b < blocks; b++) {
+            memcpy(block, &p_samples[b * EMG_PIPELINE_BLOCK_LEN], sizeof(block));
+            (void)emg_core_process_block(block, EMG_PIPELINE_BLOCK_LEN, (uint32_t)index);
+            index += EMG_PIPELINE_BLOCK_LEN;
+
+            uint32_t switch_index;
+            if (emg_core_take_rate_switch(&switch_index)) {
+                emg_host_log("info", "Adaptive rate: %s @ sample %u",
+                             emg_core_full_rate() ? "full" : "rest", switch_index);
+            }
+
+            int16_t out;
+            while (emg_core_stream_pop(&out, NULL)) {
+                streamed++;
+                if (p_out != NULL) {
+                    fprintf(p_out, "%d\n", out);
+                }
+            }
+
+            // Contadores de 16 bits do pipeline: coleta antes de saturar
+            if (b % 100 == 99 || b == blocks - 1) {
+                (void)emg_pipeline_take_stats(stats, n_stages);
+                for (uint8_t i = 0; i < n_stages; i++) {
+                    stage_ns[i]      += stats[i].cycles;
+                    stage_samples[i] += stats[i].samples;
+                }
+            }
+        }
+    }
+    double elapsed = now_s() - start;
+
+    printf("samples: %llu in %.3f s = %.2f Msamples/s (%.1fx real time)\n",
+           (unsigned long long)index, elapsed, index / elapsed / 1e6,
+           index / elapsed / EMG_SAMPLE_RATE_HZ);
+    printf("stream: %llu samples @ %u Hz | activations %u | fatigue %u | psd %u | class changes %u | wiper 0x%02X\n",
+           (unsigned long long)streamed, emg_decimator_rate_hz(), m_activations, m_fatigue_windows,
+           m_psd_windows, m_class_changes, m_wiper);
+    printf("%-12s %10s %12s\n", "stage", "ns/sample", "samples");
+    for (uint8_t i = 0; i < n_stages; i++) {
+        printf("%-12s %10.1f %12llu\n", emg_pipeline_stage_name(i),
+               stage_samples[i] ? (double)stage_ns[i] / stage_samples[i] : 0.0,
+               (unsigned long long)stage_samples[i]);
+    }
+
+    if (p_out != NULL) {
+        fclose(p_out);
+    }
+    free(p_samples);
+    return 0;
+}
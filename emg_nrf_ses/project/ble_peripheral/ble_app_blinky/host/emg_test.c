@@ -0,0 +1,276 @@
+/*
+ * Testes unitários do núcleo de DSP no host: mesmos fontes do firmware
+ * (CORE_SRCS do Makefile), sem stubs de rádio. Cada teste imprime o que
+ * mediu; o processo sai com 1 se algum falhar.
+ *
+ *   make test
+ */
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "emg_config.h"
+#include "emg_bandpass.h"
+#include "emg_welch.h"
+#include "emg_codec.h"
+#include "emg_adaptive.h"
+#include "emg_stats.h"
+
+static uint32_t m_checks;
+static uint32_t m_failures;
+
+void emg_host_log(char const * p_level, char const * p_fmt, ...)
+{
+    (void)p_level;
+    (void)p_fmt;
+}
+
+#define CHECK(cond, ...)                                                  \
+    do {                                                                  \
+        m_checks++;                                                       \
+        if (!(cond)) {                                                    \
+            m_failures++;                                                 \
+            fprintf(stderr, "FAIL %s:%d: %s: ", __FILE__, __LINE__, #cond); \
+            fprintf(stderr, __VA_ARGS__);                                 \
+            fputc('\n', stderr);                                          \
+        }                                                                 \
+    } while (0)
+
+// === Passa-banda: IIR e FIR com a mesma banda na taxa do firmware ===
+#define GAIN_AMPLITUDE      8000.0
+#define GAIN_SETTLE_S       1
+#define GAIN_MEASURE_S      2
+
+// Ganho de regime de uma senoide (razão de RMS, depois do transitório)
+static double bandpass_gain(emg_bandpass_type_t type, double freq_hz)
+{
+    emg_bandpass_init();
+    (void)emg_bandpass_select(type);
+
+    double in_sq = 0.0, out_sq = 0.0;
+    uint32_t total = (GAIN_SETTLE_S + GAIN_MEASURE_S) * EMG_SAMPLE_RATE_HZ;
+    for (uint32_t n = 0; n < total; n++) {
+        double  x   = GAIN_AMPLITUDE * sin(2.0 * M_PI * freq_hz * n / EMG_SAMPLE_RATE_HZ);
+        int16_t in  = (int16_t)lrint(x);
+        int16_t out = emg_bandpass_process(in);
+        if (n >= GAIN_SETTLE_S * EMG_SAMPLE_RATE_HZ) {
+            in_sq  += (double)in * in;
+            out_sq += (double)out * out;
+        }
+    }
+    return sqrt(out_sq / in_sq);
+}
+
+static void test_bandpass_gain(void)
+{
+    static const struct {
+        double freq_hz;
+        double min_gain;            // Os dois filtros
+        double max_diff;            // |IIR - FIR|
+    } points[] = {
+        {  20.0, 0.40, 0.25 },      // Borda inferior: IIR -3 dB, FIR ~-6 dB
+        { 100.0, 0.95, 0.05 },
+        { 300.0, 0.90, 0.10 },
+    };
+
+    for (size_t i = 0; i < sizeof(points) / sizeof(points[0]); i++) {
+        double iir = bandpass_gain(EMG_BANDPASS_IIR, points[i].freq_hz);
+        double fir = bandpass_gain(EMG_BANDPASS_FIR, points[i].freq_hz);
+        printf("bandpass %5.0f Hz: IIR %.3f, FIR %.3f\n", points[i].freq_hz, iir, fir);
+        CHECK(iir >= points[i].min_gain && iir <= 1.05, "IIR %.3f @ %.0f Hz", iir, points[i].freq_hz);
+        CHECK(fir >= points[i].min_gain && fir <= 1.05, "FIR %.3f @ %.0f Hz", fir, points[i].freq_hz);
+        CHECK(fabs(iir - fir) <= points[i].max_diff, "IIR %.3f vs FIR %.3f @ %.0f Hz",
+              iir, fir, points[i].freq_hz);
+    }
+
+    // Fora da banda os dois cortam
+    double iir_dc = bandpass_gain(EMG_BANDPASS_IIR, 2.0);
+    double fir_dc = bandpass_gain(EMG_BANDPASS_FIR, 2.0);
+    printf("bandpass     2 Hz: IIR %.3f, FIR %.3f\n", iir_dc, fir_dc);
+    CHECK(iir_dc < 0.05 && fir_dc < 0.05, "IIR %.3f, FIR %.3f @ 2 Hz", iir_dc, fir_dc);
+}
+
+// === Welch: janela deslizante de N s com passo de 1 s ===
+static void test_welch_sliding(void)
+{
+    CHECK(!emg_welch_configure(6, 9), "64 pontos x 9 s passa de 255 segmentos");
+    CHECK(emg_welch_configure(6, 8), "64 pontos x 8 s cabe");
+    CHECK(emg_welch_configure(8, EMG_WELCH_MAX_SECONDS), "256 pontos x 10 s cabe");
+
+    emg_welch_init();
+    CHECK(emg_welch_configure(8, 3), "256 pontos x 3 s");
+
+    static emg_welch_snapshot_t snap;
+    uint32_t snapshots = 0, first_at = 0;
+    uint8_t  min_segments = UINT8_MAX, max_segments = 0;
+    for (uint32_t n = 0; n < 10 * EMG_SAMPLE_RATE_HZ; n++) {
+        int16_t  x = (int16_t)lrint(4000.0 * sin(2.0 * M_PI * 100.0 * n / EMG_SAMPLE_RATE_HZ));
+        uint16_t len;
+        if (emg_welch_push(x, &snap, &len)) {
+            if (snapshots++ == 0) {
+                first_at = n + 1;
+            }
+            if (snap.n_segments < min_segments) min_segments = snap.n_segments;
+            if (snap.n_segments > max_segments) max_segments = snap.n_segments;
+        }
+    }
+    printf("welch 3 s: %u snapshots, first @ %u, %u..%u segments\n",
+           snapshots, first_at, min_segments, max_segments);
+    CHECK(first_at == 3 * EMG_SAMPLE_RATE_HZ, "primeiro snapshot @ %u", first_at);
+    CHECK(snapshots == 8, "%u snapshots em 10 s", snapshots);
+    CHECK(min_segments >= 22 && max_segments <= 24, "%u..%u segmentos", min_segments, max_segments);
+}
+
+// === Codec: limite de erro conferido no bitstream decodificado ===
+#define CODEC_N             60
+#define CODEC_BLOCKS        2000
+
+static uint32_t m_rng = 0x12345678u;
+
+static uint32_t rng_next(void)
+{
+    m_rng ^= m_rng << 13;
+    m_rng ^= m_rng >> 17;
+    m_rng ^= m_rng << 5;
+    return m_rng;
+}
+
+// Blocos de teste: ruído, senoide, degraus de fundo de escala e alternância ±32767
+static void codec_block(uint32_t kind, int16_t * p_x)
+{
+    for (uint8_t i = 0; i < CODEC_N; i++) {
+        switch (kind % 5) {
+        case 0:  p_x[i] = (int16_t)(rng_next() & 0xFFFF); break;
+        case 1:  p_x[i] = (int16_t)lrint(30000.0 * sin(0.7 * i + kind)); break;
+        case 2:  p_x[i] = (i < (kind % CODEC_N)) ? INT16_MAX : INT16_MIN; break;
+        case 3:  p_x[i] = (i & 1) ? INT16_MIN : INT16_MAX; break;
+        default: p_x[i] = (int16_t)((int32_t)(rng_next() % 201) - 100); break;
+        }
+    }
+    if (kind % 7 == 0) {
+        // Degrau isolado no meio de sinal pequeno
+        p_x[rng_next() % CODEC_N] = (rng_next() & 1) ? INT16_MAX : INT16_MIN;
+    }
+}
+
+static void test_codec_round_trip(void)
+{
+    static const uint16_t max_errors[] = { 0, 1, 5, 50, 1000, 20000 };
+    uint32_t worst_fail = 0, failures = 0, wavelet = 0, total = 0;
+
+    for (size_t e = 0; e < sizeof(max_errors) / sizeof(max_errors[0]); e++) {
+        for (uint32_t kind = 0; kind < CODEC_BLOCKS; kind++) {
+            int16_t x[CODEC_N], y[CODEC_N];
+            emg_codec_packet_t pkt;
+            codec_block(kind, x);
+
+            uint16_t len = emg_codec_encode(x, CODEC_N, max_errors[e], 0x0021, &pkt);
+            uint8_t  n   = emg_codec_decode(&pkt, len, y);
+            total++;
+            wavelet += (pkt.encoding == EMG_ENCODING_WAVELET);
+
+            uint32_t worst = 0;
+            for (uint8_t i = 0; i < n; i++) {
+                uint32_t err = (uint32_t)abs((int32_t)y[i] - x[i]);
+                if (err > worst) worst = err;
+            }
+            if (n != CODEC_N || worst > max_errors[e] || len > sizeof(pkt) ||
+                pkt.quality_flags != 0x0021) {
+                failures++;
+                if (worst > worst_fail) worst_fail = worst;
+            }
+        }
+    }
+    printf("codec: %u blocks, %u wavelet, %u failures (worst %u)\n", total, wavelet, failures, worst_fail);
+    CHECK(failures == 0, "%u blocos fora do limite (pior erro %u)", failures, worst_fail);
+    CHECK(wavelet > total / 2, "só %u de %u comprimidos", wavelet, total);
+
+    // Pacotes truncados ou com campos inválidos são recusados
+    int16_t x[CODEC_N], y[CODEC_N];
+    emg_codec_packet_t pkt;
+    codec_block(1, x);
+    uint16_t len = emg_codec_encode(x, CODEC_N, 5, 0, &pkt);
+    CHECK(pkt.encoding == EMG_ENCODING_WAVELET, "senoide comprimida");
+    CHECK(emg_codec_decode(&pkt, EMG_CODEC_HEADER_LEN + 1, y) == 0, "truncado");
+    pkt.n_samples = 61;
+    CHECK(emg_codec_decode(&pkt, len, y) == 0, "n_samples > máximo");
+}
+
+// === P²: quantis sem guardar amostras, contra os valores exatos ===
+static void test_p2_quantiles(void)
+{
+    static const float quantiles[] = { 0.10f, 0.50f, 0.90f, 0.99f };
+
+    for (size_t q = 0; q < sizeof(quantiles) / sizeof(quantiles[0]); q++) {
+        emg_p2_t uniform, ramp;
+        emg_p2_init(&uniform, quantiles[q]);
+        emg_p2_init(&ramp, quantiles[q]);
+
+        // Uniforme 0..1000 e dente de serra 0..9999 (entrada ordenada em trechos)
+        for (uint32_t i = 0; i < 100000; i++) {
+            emg_p2_push(&uniform, (float)(rng_next() % 100001) / 100.0f);
+            emg_p2_push(&ramp, (float)(i % 10000));
+        }
+        float u = emg_p2_value(&uniform);
+        float r = emg_p2_value(&ramp);
+        printf("p2 q%.2f: uniform %.1f (%.0f), ramp %.0f (%.0f)\n",
+               quantiles[q], u, 1000.0f * quantiles[q], r, 10000.0f * quantiles[q]);
+        CHECK(fabsf(u - 1000.0f * quantiles[q]) <= 10.0f, "uniforme q%.2f = %.1f", quantiles[q], u);
+        CHECK(fabsf(r - 10000.0f * quantiles[q]) <= 200.0f, "rampa q%.2f = %.0f", quantiles[q], r);
+    }
+
+    // Poucas amostras: valor exato das que existem
+    emg_p2_t few;
+    emg_p2_init(&few, 0.5f);
+    emg_p2_push(&few, 3.0f);
+    emg_p2_push(&few, 1.0f);
+    emg_p2_push(&few, 2.0f);
+    CHECK(fabsf(emg_p2_value(&few) - 2.0f) < 1e-6f, "mediana de 3 = %.2f", emg_p2_value(&few));
+}
+
+// === Taxa adaptativa: detector de onset em REST na escala do ruído a 330 SPS ===
+// Retorna quantas amostras (grade de 1 kHz) o estado ficou igual a `expected`
+static uint32_t adaptive_feed(int16_t amplitude, uint32_t n, emg_adapt_state_t expected)
+{
+    uint32_t held = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        (void)emg_adaptive_push((i & 1) ? amplitude : (int16_t)-amplitude);
+        if (emg_adaptive_state() != expected) {
+            break;
+        }
+        held++;
+    }
+    return held;
+}
+
+static void test_adaptive_rest(void)
+{
+    emg_adaptive_init();
+    emg_adaptive_enable(true);
+
+    // Piso aprendido em FULL; 2 s abaixo do limiar entram em REST
+    (void)adaptive_feed(100, 4 * EMG_SAMPLE_RATE_HZ, EMG_ADAPT_FULL);
+    CHECK(emg_adaptive_state() == EMG_ADAPT_REST, "repouso não detectado");
+
+    // Ruído menor do ADC a 330 SPS não acorda; onset a 4.5x o piso acorda
+    uint32_t quiet = adaptive_feed(57, 2 * EMG_SAMPLE_RATE_HZ, EMG_ADAPT_REST);
+    uint32_t wake  = adaptive_feed(450, 100, EMG_ADAPT_REST);
+    printf("adaptive: rest %u ms quiet, wake after %u ms\n", quiet, wake);
+    CHECK(quiet == 2 * EMG_SAMPLE_RATE_HZ, "acordou com ruído após %u ms", quiet);
+    CHECK(wake <= 2 * EMG_ADAPT_REST_DECIM, "onset levou %u ms", wake);
+}
+
+int main(void)
+{
+    test_bandpass_gain();
+    test_welch_sliding();
+    test_codec_round_trip();
+    test_p2_quantiles();
+    test_adaptive_rest();
+
+    printf("%u checks, %u failures\n", m_checks, m_failures);
+    return (m_failures == 0) ? 0 : 1;
+}
@@ -11,6 +11,9 @@
 #include "nrfx_uart.h"
 #include "nrfx_twi.h"
 #include "nrf_gpio.h"
+#include "nrfx_gpiote.h"
+#include "nrfx_timer.h"
+#include "nrfx_ppi.h"
 #include "ADS112C04.h"
 
 #include "nrf_sdh.h"
@@ -36,6 +39,35 @@
 #include "nrf_pwr_mgmt.h"
 
 #include "ble_emg_service.h" // Adicionando serviço EMG
+#include "ble_emg_link.h"
+#include "emg_config.h"
+#include "emg_spectral.h"
+#include "emg_activation.h"
+#include "emg_decimator.h"
+#include "emg_quality.h"
+#include "emg_bandpass.h"
+#include "emg_fir.h"
+#include "emg_welch.h"
+#include "emg_codec.h"
+#include "emg_features.h"
+#include "emg_classifier.h"
+#include "emg_stats.h"
+#include "emg_capture.h"
+#include "emg_prefilter.h"
+#include "emg_pipeline.h"
+#include "emg_store.h"
+#include "emg_evoked.h"
+#include "emg_cross.h"
+#include "emg_adaptive.h"
+#include "emg_backlog.h"
+#include "emg_sched.h"
+#include "emg_core.h"
+#include "nrf_balloc.h"
+#if EMG_RTOS
+#include "FreeRTOS.h"
+#include "task.h"
+#include "nrf_sdh_freertos.h"
+#endif
 
 #define DEVICE_NAME                     "EMG_BLE"
 #define APP_BLE_OBSERVER_PRIO           3
@@ -43,15 +75,9 @@
 #define APP_ADV_INTERVAL                320   // 200ms — reduz wake-ups de rádio durante discovery
 #define APP_ADV_DURATION                BLE_GAP_ADV_TIMEOUT_GENERAL_UNLIMITED
 
-// Otimizado para baixo consumo: pacote de 60 amostras leva 60ms para encher ao ADC 1kSPS,
-// então 75-100ms de intervalo é suficiente sem desperdício de rádio
-#define MIN_CONN_INTERVAL               MSEC_TO_UNITS(75, UNIT_1_25_MS)    // 75ms = 60 units
-#define MAX_CONN_INTERVAL               MSEC_TO_UNITS(100, UNIT_1_25_MS)   // 100ms = 80 units
-#define SLAVE_LATENCY                   0
-#define CONN_SUP_TIMEOUT                MSEC_TO_UNITS(6000, UNIT_10_MS)
-
-#define FIRST_CONN_PARAMS_UPDATE_DELAY  (20000 / 0.32768) // Substituindo APP_TIMER_TICKS
-#define NEXT_CONN_PARAMS_UPDATE_DELAY   (5000 / 0.32768)
+// Intervalo, latency, PHY e data length vêm dos perfis do link (ble_emg_link.c)
+#define FIRST_CONN_PARAMS_UPDATE_DELAY  APP_TIMER_TICKS(20000)   // Segue APP_TIMER_CONFIG_RTC_FREQUENCY
+#define NEXT_CONN_PARAMS_UPDATE_DELAY   APP_TIMER_TICKS(5000)
 #define MAX_CONN_PARAMS_UPDATE_COUNT    3
 
 #define DEAD_BEEF                       0xDEADBEEF
@@ -64,13 +90,29 @@
 #define I2C_SDA_PIN       4
 #define I2C_SCL_PIN       5
 #define I2C_INSTANCE_ID   0
+#define TRIGGER_PIN       11          // Entrada de trigger externo (ativa em nível baixo)
+#define DRDY_PIN          29          // DRDY# do ADS112C04 (D3, pull-up externo de 4k7)
 
-#define FIFO_SIZE         64
 #define UART_BUFFER_SIZE  16
 
 NRF_BLE_GATT_DEF(m_gatt);
 NRF_BLE_QWR_DEF(m_qwr);
 APP_TIMER_DEF(m_led_timer_id);
+APP_TIMER_DEF(m_link_timer_id);
+
+// Eventos do loop principal (índice da tabela m_events, despachados pelo app_scheduler)
+typedef enum {
+    EVT_ADC_READY = 0,                // Borda de DRDY: lê a conversão do ADC
+    EVT_BLOCK_READY,                  // Bloco completo: pipeline DSP
+    EVT_STREAM_READY,                 // Bloco processado: empacotamento e telemetria
+    EVT_TX_COMPLETE,                  // SoftDevice liberou a fila: envia o que espera
+    EVT_GAIN_CHANGE,                  // Client escreveu o ganho
+    EVT_CONFIG_CHANGE,                // Escrita de configuração, CCCD ou conexão
+    EVT_TRIGGER,                      // Borda no pino de trigger externo
+    EVT_ACQ_CHANGE,                   // Gerenciador de streams ligou/desligou a aquisição
+    EVT_LINK_TICK,                    // 1 s: perfil do link pela demanda e vazão por perfil
+    EVT_COUNT
+} app_evt_t;
 
 ble_emg_service_t m_emg_service; // Instância do serviço EMG manualmente declarada
 
@@ -104,6 +146,11 @@ static void led_blink_handler(void * p_context)
     nrf_gpio_pin_toggle(LED_PIN);
 }
 
+static void link_timer_handler(void * p_context)
+{
+    emg_sched_post(EVT_LINK_TICK);
+}
+
 static void timers_init(void)
 {
     NRF_LOG_INFO("Initializing timers...");
@@ -112,6 +159,10 @@ static void timers_init(void)
 
     err_code = app_timer_create(&m_led_timer_id, APP_TIMER_MODE_REPEATED, led_blink_handler);
     APP_ERROR_CHECK(err_code);
+
+    err_code = app_timer_create(&m_link_timer_id, APP_TIMER_MODE_REPEATED, link_timer_handler);
+    APP_ERROR_CHECK(err_code);
+
     NRF_LOG_INFO("Timers initialized successfully");
 }
 static void gap_params_init(void)
@@ -120,6 +171,7 @@ static void gap_params_init(void)
     ret_code_t              err_code;
     ble_gap_conn_params_t   gap_conn_params;
     ble_gap_conn_sec_mode_t sec_mode;
+    ble_emg_link_cfg_t const * p_link = ble_emg_link_cfg(BLE_EMG_LINK_INITIAL);
 
     BLE_GAP_CONN_SEC_MODE_SET_OPEN(&sec_mode);
 
@@ -131,10 +183,12 @@ static void gap_params_init(void)
 
     memset(&gap_conn_params, 0, sizeof(gap_conn_params));
 
-    gap_conn_params.min_conn_interval = MIN_CONN_INTERVAL;
-    gap_conn_params.max_conn_interval = MAX_CONN_INTERVAL;
-    gap_conn_params.slave_latency     = SLAVE_LATENCY;
-    gap_conn_params.conn_sup_timeout  = CONN_SUP_TIMEOUT;
+    // PPCP = perfil inicial; o ble_conn_params negocia a partir dele e o
+    // gerenciador de perfis troca em tempo de execução
+    gap_conn_params.min_conn_interval = p_link->min_interval;
+    gap_conn_params.max_conn_interval = p_link->max_interval;
+    gap_conn_params.slave_latency     = p_link->slave_latency;
+    gap_conn_params.conn_sup_timeout  = p_link->sup_timeout;
 
     err_code = sd_ble_gap_ppcp_set(&gap_conn_params);
     APP_ERROR_CHECK(err_code);
@@ -153,6 +207,7 @@ static void gatt_evt_handler(nrf_ble_gatt_t * p_gatt, nrf_ble_gatt_evt_t const *
         // Com MTU 247 = 244 bytes úteis = 122 amostras int16
         m_emg_service.conn_handle = p_evt->conn_handle;
     }
+    ble_emg_link_on_gatt_evt(p_evt);
 }
 
 static void gatt_init(void)
@@ -165,7 +220,10 @@ static void gatt_init(void)
     err_code = nrf_ble_gatt_att_mtu_periph_set(&m_gatt, NRF_SDH_BLE_GATT_MAX_MTU_SIZE);
     APP_ERROR_CHECK(err_code);
 
-    NRF_LOG_INFO("GATT initialized: max_mtu=%d", NRF_SDH_BLE_GATT_MAX_MTU_SIZE);
+    NRF_LOG_INFO("GATT initialized: max_mtu=%d, data length=%d",
+                 NRF_SDH_BLE_GATT_MAX_MTU_SIZE, NRF_SDH_BLE_GAP_DATA_LENGTH);
+
+    ble_emg_link_init(&m_gatt);
 }
 
 static void advertising_init(void)
@@ -230,20 +288,16 @@ static void services_init(void)
  * @details This function will be called for all events in the Connection Parameters Module that
  *          are passed to the application.
  *
- * @note All this function does is to disconnect. This could have been done by simply
- *       setting the disconnect_on_fail config parameter, but instead we use the event
- *       handler mechanism to demonstrate its use.
+ * @note A central that rejects the parameters of a link profile keeps the connection
+ *       on the interval it negotiated; the profile manager reports the actual values.
  *
  * @param[in] p_evt  Event received from the Connection Parameters Module.
  */
 static void on_conn_params_evt(ble_conn_params_evt_t * p_evt)
 {
-    ret_code_t err_code;
-
     if (p_evt->evt_type == BLE_CONN_PARAMS_EVT_FAILED)
     {
-        err_code = sd_ble_gap_disconnect(m_conn_handle, BLE_HCI_CONN_INTERVAL_UNACCEPTABLE);
-        APP_ERROR_CHECK(err_code);
+        NRF_LOG_WARNING("Central rejected link profile parameters - keeping negotiated interval");
     }
 }
 
@@ -315,10 +369,7 @@ static void ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context)
             APP_ERROR_CHECK(err_code);
             m_emg_service.conn_handle = m_conn_handle;
             NRF_LOG_INFO("EMG service connection handle assigned");
-
-            // Mantém 1M PHY — menor consumo; throughput de 120 bytes/100ms é suficiente
-            NRF_LOG_INFO("Connected on 1M PHY (power-saving mode)");
-
+            emg_sched_post(EVT_CONFIG_CHANGE);
             break;
 
         case BLE_GAP_EVT_DISCONNECTED:
@@ -331,6 +382,20 @@ static void ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context)
             m_emg_service.conn_handle = BLE_CONN_HANDLE_INVALID;
             APP_ERROR_CHECK(err_code);
             advertising_start();
+            emg_sched_post(EVT_CONFIG_CHANGE);
+            break;
+
+        case BLE_GATTS_EVT_WRITE:
+            // O observer do serviço grava o valor no mesmo despacho; o handler lê depois
+            if (p_ble_evt->evt.gatts_evt.params.write.handle == m_emg_service.gain_char_handles.value_handle) {
+                emg_sched_post(EVT_GAIN_CHANGE);
+            } else {
+                emg_sched_post(EVT_CONFIG_CHANGE);
+            }
+            break;
+
+        case BLE_GATTS_EVT_HVN_TX_COMPLETE:
+            emg_sched_post(EVT_TX_COMPLETE);
             break;
 
         case BLE_GAP_EVT_SEC_PARAMS_REQUEST:
@@ -342,18 +407,6 @@ static void ble_evt_handler(ble_evt_t const * p_ble_evt, void * p_context)
             APP_ERROR_CHECK(err_code);
             break;
 
-        case BLE_GAP_EVT_PHY_UPDATE_REQUEST:
-        {
-            // Aceita somente 1M PHY para menor consumo
-            ble_gap_phys_t const phys =
-            {
-                .rx_phys = BLE_GAP_PHY_1MBPS,
-                .tx_phys = BLE_GAP_PHY_1MBPS,
-            };
-            err_code = sd_ble_gap_phy_update(p_ble_evt->evt.gap_evt.conn_handle, &phys);
-            APP_ERROR_CHECK(err_code);
-        } break;
-
         case BLE_GATTS_EVT_SYS_ATTR_MISSING:
             NRF_LOG_INFO("System attributes missing - initializing");
             // No system attributes have been stored.
@@ -403,10 +456,21 @@ static void ble_stack_init(void)
 
     // Configure the BLE stack using the default settings.
     // Fetch the start address of the application RAM.
+    // RAM_START dos projetos cobre a tabela de atributos de 4 KB e a fila HVN
+    // (o data length não entra no sd_ble_cfg_set); com pouca RAM o
+    // nrf_sdh_ble_enable devolve NO_MEM e loga o mínimo.
     uint32_t ram_start = 0;
     err_code = nrf_sdh_ble_default_cfg_set(APP_BLE_CONN_CFG_TAG, &ram_start);
     APP_ERROR_CHECK(err_code);
 
+    // Fila de notificações por conexão: vários pacotes por connection event
+    ble_cfg_t ble_cfg;
+    memset(&ble_cfg, 0, sizeof(ble_cfg));
+    ble_cfg.conn_cfg.conn_cfg_tag                            = APP_BLE_CONN_CFG_TAG;
+    ble_cfg.conn_cfg.params.gatts_conn_cfg.hvn_tx_queue_size = EMG_HVN_TX_QUEUE_SIZE;
+    err_code = sd_ble_cfg_set(BLE_CONN_CFG_GATTS, &ble_cfg, ram_start);
+    APP_ERROR_CHECK(err_code);
+
     // Enable BLE stack.
     err_code = nrf_sdh_ble_enable(&ram_start);
     APP_ERROR_CHECK(err_code);
@@ -416,6 +480,9 @@ static void ble_stack_init(void)
 
     // Register EMG service observer to handle HVN_TX_COMPLETE events
     NRF_SDH_BLE_OBSERVER(m_emg_service_observer, APP_BLE_OBSERVER_PRIO, ble_emg_service_on_ble_evt, &m_emg_service);
+
+    // Perfis do link: parâmetros negociados e resposta ao pedido de PHY do central
+    NRF_SDH_BLE_OBSERVER(m_link_observer, APP_BLE_OBSERVER_PRIO, ble_emg_link_on_ble_evt, NULL);
 }
 
 
@@ -439,6 +506,16 @@ static void power_management_init(void)
 }
 
 
+#if EMG_RTOS
+/**@brief FreeRTOS idle hook: flushes the log before tickless idle sleeps.
+ */
+void vApplicationIdleHook(void)
+{
+    while (NRF_LOG_PROCESS())
+    {
+    }
+}
+#else
 /**@brief Function for handling the idle state (main loop).
  *
  * @details If there is no pending log operation, then sleep until next the next event occurs.
@@ -450,6 +527,7 @@ static void idle_state_handle(void)
         nrf_pwr_mgmt_run();
     }
 }
+#endif
 
 
 // === DS3502 ===
@@ -472,7 +550,6 @@ static void idle_state_handle(void)
 // === Desired Resistance Setting ===
 #define DEFAULT_RESITANCE      DS3502_RES_1K_OHM
 #define RESISTANCE_SETTING     DEFAULT_RESITANCE
-volatile uint8_t gain_level = 10;
 
 bool ds3502_set_resistance(nrfx_twi_t *twi, uint8_t value) {
     if (value > 0x7F) value = 0x7F;
@@ -482,24 +559,6 @@ bool ds3502_set_resistance(nrfx_twi_t *twi, uint8_t value) {
 
     return (err == NRFX_SUCCESS);
 }
-// === Butterworth Filter (Order 2, Bandpass 20–400 Hz, Fs = 2000 Hz) ===
-#define NZEROS 4
-#define NPOLES 4
-#define GAIN   5.182411747f
-
-static float xv[NZEROS + 1] = {0}, yv[NPOLES + 1] = {0};
-
-float butterworth_filter(float input) {
-    xv[0] = xv[1]; xv[1] = xv[2]; xv[2] = xv[3]; xv[3] = xv[4];
-    xv[4] = input / GAIN;
-    yv[0] = yv[1]; yv[1] = yv[2]; yv[2] = yv[3]; yv[3] = yv[4];
-    yv[4] = (xv[0] + xv[4]) - 2 * xv[2]
-          + (-0.2066719852f * yv[0]) + (0.8192636853f * yv[1])
-          + (-1.9509646898f * yv[2]) + (2.3350824021f * yv[3]);
-    return yv[4];
-}
-
-
 #define ADC_FULL_SCALE 32768  // pois o range vai de -32768 a +32767
 #define VREF           5.0f
 int16_t remove_offset(int16_t raw) {
@@ -559,26 +618,6 @@ void uart_print_async(const char *str) {
     }
 }
 
-// === FIFO Sample Buffer ===
-static int16_t fifo[FIFO_SIZE];
-static volatile uint8_t fifo_head = 0;
-static volatile uint8_t fifo_tail = 0;
-
-void fifo_push(int16_t value) {
-    uint8_t next = (fifo_head + 1) % FIFO_SIZE;
-    if (next != fifo_tail) {
-        fifo[fifo_head] = value;
-        fifo_head = next;
-    }
-}
-
-bool fifo_pop(int16_t *value) {
-    if (fifo_head == fifo_tail) return false;
-    *value = fifo[fifo_tail];
-    fifo_tail = (fifo_tail + 1) % FIFO_SIZE;
-    return true;
-}
-
 // === I2C Setup ===
 static nrfx_twi_t m_twi = NRFX_TWI_INSTANCE(0);
 
@@ -586,7 +625,7 @@ void twi_init(void) {
     nrfx_twi_config_t config = {
         .scl = I2C_SCL_PIN,
         .sda = I2C_SDA_PIN,
-        .frequency = NRF_TWI_FREQ_100K,
+        .frequency = NRF_TWI_FREQ_100K,           // ADS112C04_TWI_FREQ_HZ
         .interrupt_priority = NRFX_TWI_DEFAULT_CONFIG_IRQ_PRIORITY,
         .hold_bus_uninit = false
     };
@@ -607,6 +646,161 @@ void gpio_init(void) {
     nrf_gpio_pin_write(RST_PIN, 1);
 }
 
+// === Trigger externo (GPIOTE + PPI + TIMER2) ===
+// A borda do pino captura o TIMER2 em hardware (PPI: GPIOTE IN → CAPTURE[0]) e
+// cada leitura do ADC captura CC[1]; a latência da IRQ e do loop principal não
+// entra na amostra marcada. O TIMER (1 MHz, HFCLK) só roda com a média evocada ligada.
+#define TRIGGER_CC_EDGE     NRF_TIMER_CC_CHANNEL0
+#define TRIGGER_CC_SAMPLE   NRF_TIMER_CC_CHANNEL1
+
+static const nrfx_timer_t m_trigger_timer = NRFX_TIMER_INSTANCE(2);
+static volatile uint32_t  m_trigger_ticks;          // Instante da borda (µs)
+static bool               m_trigger_timer_on = false;
+static uint32_t           m_sample_count = 0;       // Amostras lidas do ADC desde o boot
+static uint32_t           m_sample_ticks;           // Instante da última leitura (µs)
+
+static void trigger_pin_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action) {
+    m_trigger_ticks = nrfx_timer_capture_get(&m_trigger_timer, TRIGGER_CC_EDGE);
+    emg_sched_post(EVT_TRIGGER);
+}
+
+static void trigger_timer_handler(nrf_timer_event_t event_type, void * p_context) {
+    // Sem eventos de compare: o TIMER só é capturado
+}
+
+void trigger_init(void) {
+    if (!nrfx_gpiote_is_init()) {
+        APP_ERROR_CHECK(nrfx_gpiote_init());
+    }
+    // Alta precisão: evento IN dedicado, necessário para o PPI
+    nrfx_gpiote_in_config_t config = NRFX_GPIOTE_CONFIG_IN_SENSE_HITOLO(true);
+    config.pull = NRF_GPIO_PIN_PULLUP;
+    APP_ERROR_CHECK(nrfx_gpiote_in_init(TRIGGER_PIN, &config, trigger_pin_handler));
+
+    nrfx_timer_config_t timer_cfg = NRFX_TIMER_DEFAULT_CONFIG;
+    timer_cfg.frequency = NRF_TIMER_FREQ_1MHz;
+    timer_cfg.mode      = NRF_TIMER_MODE_TIMER;
+    timer_cfg.bit_width = NRF_TIMER_BIT_WIDTH_32;
+    APP_ERROR_CHECK(nrfx_timer_init(&m_trigger_timer, &timer_cfg, trigger_timer_handler));
+
+    nrf_ppi_channel_t ppi_channel;
+    APP_ERROR_CHECK(nrfx_ppi_channel_alloc(&ppi_channel));
+    APP_ERROR_CHECK(nrfx_ppi_channel_assign(ppi_channel,
+                                            nrfx_gpiote_in_event_addr_get(TRIGGER_PIN),
+                                            nrfx_timer_task_address_get(&m_trigger_timer,
+                                                                        NRF_TIMER_TASK_CAPTURE0)));
+    APP_ERROR_CHECK(nrfx_ppi_channel_enable(ppi_channel));
+
+    nrfx_gpiote_in_event_enable(TRIGGER_PIN, true);
+}
+
+static void trigger_timer_enable(bool enable) {
+    if (enable == m_trigger_timer_on) {
+        return;
+    }
+    if (enable) {
+        nrfx_timer_clear(&m_trigger_timer);
+        nrfx_timer_enable(&m_trigger_timer);
+    } else {
+        nrfx_timer_disable(&m_trigger_timer);
+    }
+    m_trigger_timer_on = enable;
+}
+
+// Chamado a cada amostra lida do ADC (timestamp de leitura, não de conversão)
+static void trigger_sample_read(void) {
+    if (m_trigger_timer_on) {
+        m_sample_ticks = nrfx_timer_capture(&m_trigger_timer, TRIGGER_CC_SAMPLE);
+    }
+    m_sample_count++;
+}
+
+// Resolve a borda para a primeira amostra lida depois dela
+static void trigger_resolve(emg_trigger_evt_t * p_evt) {
+    p_evt->sample_index = m_sample_count;     // Sem timestamp: próxima amostra
+    p_evt->latency_us   = 0;
+    p_evt->trial        = 0;
+
+    int32_t ago_us = (int32_t)(m_sample_ticks - m_trigger_ticks);
+    if (!m_trigger_timer_on || m_sample_count == 0 || ago_us < 0) {
+        return;
+    }
+    const uint32_t period_us = 1000000u / EMG_SAMPLE_RATE_HZ;
+    uint32_t back = (uint32_t)ago_us / period_us;
+    if (back >= m_sample_count) {
+        back = m_sample_count - 1;
+    }
+    p_evt->sample_index = m_sample_count - 1 - back;
+    p_evt->latency_us   = (uint16_t)MIN((uint32_t)ago_us - back * period_us, UINT16_MAX);
+}
+
+// === Aquisição ===
+#if EMG_CHANNEL_COUNT > 1
+// Variante multi-site: entradas single-ended AIN0..AIN(N-1), uma conversão por
+// canal em sequência; o canal 0 segue para o pipeline principal e o frame
+// completo vai para a análise entre canais no contexto do DSP (on_block_ready)
+static int16_t m_adc_frame[EMG_CHANNEL_COUNT];
+static uint8_t m_adc_channel = 0;
+#endif
+
+// Lê o ADC. Com vários canais só retorna true quando o frame fecha (canal 0 em
+// *p_sample, frame completo em m_adc_frame)
+static bool adc_read(int16_t * p_sample) {
+#if EMG_CHANNEL_COUNT > 1
+    int16_t raw;
+    if (!ads112c04_read_data(&m_twi, &raw)) {
+        return false;
+    }
+    m_adc_frame[m_adc_channel] = raw;
+    m_adc_channel = (uint8_t)((m_adc_channel + 1) % EMG_CHANNEL_COUNT);
+    // Troca + START/SYNC: o próximo DRDY já é do canal novo, sem conversão misturada
+    (void)ads112c04_select_input(&m_twi, ADS112C04_MUX_AIN0_AVSS + m_adc_channel);
+    if (m_adc_channel != 0) {
+        return false;
+    }
+    *p_sample = m_adc_frame[0];
+    return true;
+#else
+    return ads112c04_read_data(&m_twi, p_sample);
+#endif
+}
+
+// A borda de DRDY posta a leitura (tarefa de aquisição na variante FreeRTOS):
+// uma leitura por conversão, no relógio do ADC. O ADC converte na própria taxa
+// do pipeline (vezes o número de canais), então o filtro sinc dele é o
+// anti-aliasing — sem decimação aqui.
+STATIC_ASSERT(ADS112C04_RAW_DATA_RATE_SPS == EMG_SAMPLE_RATE_HZ * EMG_CHANNEL_COUNT);
+
+// O frame precisa caber no período da amostra. Um canal: conversão contínua, só
+// a leitura ocupa o I2C. Vários canais: cada troca de MUX reinicia a conversão,
+// então cada canal custa uma conversão inteira mais leitura + WREG + START, sem
+// sobreposição. Com o ADS112C04 (2000 SPS no máximo) isso passa de 1 ms já com
+// 2 canais, em 100 ou 400 kHz: o build recusa em vez de entregar uma taxa por
+// canal menor do que a que os coeficientes de 1 kHz assumem.
+#if EMG_CHANNEL_COUNT > 1
+#define ADC_FRAME_US  (EMG_CHANNEL_COUNT * (1000000UL / ADS112C04_RAW_DATA_RATE_SPS + \
+                       ADS112C04_BITS_US(ADS112C04_READ_BITS + ADS112C04_SELECT_BITS)))
+#else
+#define ADC_FRAME_US  ADS112C04_BITS_US(ADS112C04_READ_BITS)
+#endif
+#if ADC_FRAME_US > 1000000UL / EMG_SAMPLE_RATE_HZ
+#error "Frame do ADC não cabe em 1/EMG_SAMPLE_RATE_HZ: o MUX do ADS112C04 não sustenta EMG_CHANNEL_COUNT canais (análise entre canais só no build de host)"
+#endif
+
+static void drdy_pin_handler(nrfx_gpiote_pin_t pin, nrf_gpiote_polarity_t action) {
+    emg_sched_post(EVT_ADC_READY);
+}
+
+static void drdy_init(void) {
+    if (!nrfx_gpiote_is_init()) {
+        APP_ERROR_CHECK(nrfx_gpiote_init());
+    }
+    nrfx_gpiote_in_config_t config = NRFX_GPIOTE_CONFIG_IN_SENSE_HITOLO(true);
+    config.pull = NRF_GPIO_PIN_NOPULL;
+    APP_ERROR_CHECK(nrfx_gpiote_in_init(DRDY_PIN, &config, drdy_pin_handler));
+    // Evento habilitado pelo gerenciador de streams (on_acq_change)
+}
+
 // === I2C Scan ===
 void i2c_scan(void) {
     uart_print_async("Starting I2C scan...\r\n");
@@ -634,6 +828,831 @@ void check_ads112c04(void) {
     uart_print_async("ADS112C04 not detected at 0x40 or 0x41.\r\n");
 }
 
+// === Pipeline DSP ===
+// Cadeia de sinal em emg_core.c (portável, também roda no host); aqui ficam os
+// callbacks que levam as saídas do pipeline ao serviço BLE e o ganho ao DS3502.
+static bool core_gain_write(uint8_t wiper) {
+    return ds3502_set_resistance(&m_twi, wiper);
+}
+
+static void core_activation(emg_activation_evt_t const * p_evt) {
+    if (m_conn_handle != BLE_CONN_HANDLE_INVALID) {
+        (void)ble_emg_service_notify_activation(&m_emg_service, m_emg_service.conn_handle, p_evt);
+    }
+}
+
+static void core_stats(emg_stats_snapshot_t const * p_snapshot) {
+    (void)ble_emg_service_update_stats(&m_emg_service, m_emg_service.conn_handle, p_snapshot);
+}
+
+static void core_fatigue(emg_fatigue_metrics_t const * p_metrics) {
+    (void)ble_emg_service_notify_fatigue(&m_emg_service, m_emg_service.conn_handle, p_metrics);
+}
+
+static void core_psd(emg_welch_snapshot_t const * p_snapshot, uint16_t len) {
+    (void)ble_emg_service_update_psd(&m_emg_service, m_emg_service.conn_handle, p_snapshot, len);
+}
+
+#if EMG_CHANNEL_COUNT > 1
+static void core_cross(emg_cross_snapshot_t const * p_snapshot, uint16_t len) {
+    (void)ble_emg_service_notify_cross(&m_emg_service, m_emg_service.conn_handle, p_snapshot, len);
+}
+#endif
+
+static void core_class_changed(uint8_t class_id) {
+    (void)ble_emg_service_notify_class(&m_emg_service, m_emg_service.conn_handle, class_id);
+}
+
+static void core_classifier_status(emg_classifier_status_t const * p_status) {
+    (void)ble_emg_service_update_classifier_status(&m_emg_service, p_status);
+}
+
+static bool core_fatigue_subscribed(void) {
+    return ble_emg_service_is_subscribed(&m_emg_service, EMG_SUB_FATIGUE);
+}
+
+static const emg_core_platform_t m_core_platform = {
+    .gain_write         = core_gain_write,
+    .activation         = core_activation,
+    .stats              = core_stats,
+    .fatigue            = core_fatigue,
+    .psd                = core_psd,
+#if EMG_CHANNEL_COUNT > 1
+    .cross              = core_cross,
+#endif
+    .class_changed      = core_class_changed,
+    .classifier_status  = core_classifier_status,
+    .fatigue_subscribed = core_fatigue_subscribed,
+};
+
+// === Pool de pacotes BLE ===
+// O stream filtrado é montado direto no pacote final, num buffer do pool.
+// Pacotes completos esperam em ordem na fila de envio; o buffer só volta ao
+// pool quando o SoftDevice aceita a notificação (o hvx copia o payload).
+// Pool esgotado (link parado) desvia o pacote mais antigo para o backlog em
+// RAM; sem espaço no backlog as amostras esperam no store. Cada pacote tem um
+// número de sequência: o backlog é drenado junto com o stream ao vivo.
+// O buffer já reserva o header v2 (emg_stream_packet_t): o formato pedido pelo
+// client só decide de onde o envio começa. O backlog guarda o buffer inteiro.
+#define EMG_PACKET_POOL_SIZE          8       // ~0.5 s de stream @ 1kSPS
+
+NRF_BALLOC_DEF(m_packet_pool, sizeof(emg_stream_packet_t), EMG_PACKET_POOL_SIZE);
+
+static emg_stream_packet_t * m_packet_fill;                    // Pacote em montagem
+static emg_stream_packet_t * m_tx_queue[EMG_PACKET_POOL_SIZE]; // Completos, mais antigo primeiro
+static uint8_t        m_tx_queue_head;
+static uint8_t        m_tx_queue_count;
+static uint32_t       m_packet_seq;                            // Próxima sequência
+static uint32_t       m_packet_last_index;                     // Índice da última amostra em montagem
+static uint32_t       m_last_live_seq = UINT32_MAX;            // Último enviado ao vivo
+static uint32_t       m_packets_sent;
+static uint32_t       m_packet_errors;
+static bool           m_head_encoded;                          // codec_buf tem a cabeça da fila codificada
+
+// Época de ganho: trocas aplicadas e a primeira amostra lida com o ganho atual.
+// Escrita na aquisição, lida no rádio; um pacote anterior à última troca fica
+// com a época anterior (duas trocas dentro da latência do store não se separam)
+static volatile uint8_t  m_gain_epoch;
+static volatile uint32_t m_gain_change_index;
+
+static void gain_epoch_get(uint8_t * p_epoch, uint32_t * p_change_index) {
+    do {
+        *p_epoch        = m_gain_epoch;
+        *p_change_index = m_gain_change_index;
+    } while (*p_epoch != m_gain_epoch);
+}
+
+// Completa o header v2 das amostras [first_sample, last_index] já no buffer e
+// devolve as flags de qualidade atualizadas (o pacote é packed: sem ponteiro no campo)
+static uint16_t packet_header_fill(emg_packet_hdr_t * p_hdr, uint16_t quality_flags, uint32_t last_index) {
+    uint8_t  epoch;
+    uint32_t change_index;
+    gain_epoch_get(&epoch, &change_index);
+
+    int32_t since_change = (int32_t)(p_hdr->first_sample - change_index);
+    if (since_change < 0) {
+        epoch--;
+        // Troca no meio do pacote: as amostras a partir dela têm o ganho novo
+        if ((int32_t)(last_index - change_index) >= 0) {
+            quality_flags |= EMG_QUALITY_FLAG_GAIN_CHANGE;
+        }
+    }
+    p_hdr->version      = EMG_PACKET_VERSION_2;
+    p_hdr->sample_count = EMG_PACKET_SIZE;
+    p_hdr->gain_epoch   = epoch;
+    return quality_flags;
+}
+
+// Relógio das amostras (ms), base da telemetria do backlog
+static uint32_t sample_clock_ms(void) {
+    return (uint32_t)(((uint64_t)m_sample_count * 1000u) / EMG_SAMPLE_RATE_HZ);
+}
+
+static void packet_release_head(void);
+
+// Desvia o pacote mais antigo da fila para o backlog, liberando o buffer
+static bool packet_spill_head(void) {
+    if (m_tx_queue_count == 0 || emg_backlog_full() ||
+        !ble_emg_service_is_subscribed(&m_emg_service, EMG_SUB_BACKLOG)) {
+        return false;
+    }
+    // Header v2 completo: o client posiciona e escala o pacote na drenagem
+    emg_stream_packet_t * p_buf = m_tx_queue[m_tx_queue_head];
+    p_buf->hdr.encoding      = EMG_ENCODING_RAW;
+    p_buf->hdr.quality_flags = p_buf->packet.quality_flags;
+    (void)emg_backlog_push(p_buf, sample_clock_ms());
+    packet_release_head();
+    return true;
+}
+
+// Pacote em montagem (aloca do pool se preciso). NULL = pool e backlog esgotados.
+static emg_stream_packet_t * packet_fill(void) {
+    if (m_packet_fill == NULL) {
+        m_packet_fill = nrf_balloc_alloc(&m_packet_pool);
+        if (m_packet_fill == NULL && packet_spill_head()) {
+            m_packet_fill = nrf_balloc_alloc(&m_packet_pool);
+        }
+    }
+    return m_packet_fill;
+}
+
+static void packet_commit(void) {
+    // A fila tem o tamanho do pool: sempre cabe
+    uint8_t slot = (m_tx_queue_head + m_tx_queue_count) % EMG_PACKET_POOL_SIZE;
+    m_packet_fill->packet.quality_flags =
+        packet_header_fill(&m_packet_fill->hdr, m_packet_fill->packet.quality_flags, m_packet_last_index);
+    m_packet_fill->hdr.seq = m_packet_seq++;
+    m_tx_queue[slot] = m_packet_fill;
+    m_tx_queue_count++;
+    m_packet_fill = NULL;
+}
+
+static void packet_release_head(void) {
+    // O pool é LIFO: o buffer volta logo com outro pacote no mesmo endereço
+    m_head_encoded = false;
+    nrf_balloc_free(&m_packet_pool, m_tx_queue[m_tx_queue_head]);
+    m_tx_queue_head = (m_tx_queue_head + 1) % EMG_PACKET_POOL_SIZE;
+    m_tx_queue_count--;
+}
+
+// Envia a fila ao vivo em ordem e, com a capacidade que sobrar, o backlog
+static void packet_flush(void) {
+    static emg_stream_codec_t codec_buf;            // Header v2 + pacote do codec
+    static uint16_t codec_len;
+
+    while (m_tx_queue_count > 0) {
+        emg_stream_packet_t * p_buf    = m_tx_queue[m_tx_queue_head];
+        emg_packet_t        * p_packet = &p_buf->packet;
+        uint32_t              seq      = p_buf->hdr.seq;
+        bool                  v2       = (m_emg_service.packet_version == EMG_PACKET_VERSION_2);
+
+        // Client encaixa aqui os pacotes do backlog (sequências que faltam)
+        if (seq != m_last_live_seq + 1) {
+            p_packet->quality_flags |= EMG_QUALITY_FLAG_SEQ_GAP;
+        }
+        p_buf->hdr.quality_flags = p_packet->quality_flags;
+
+        uint32_t err;
+        if (m_emg_service.encoding == EMG_ENCODING_WAVELET) {
+            // Compressão com erro máximo garantido (pode cair para RAW no próprio pacote);
+            // codifica uma vez só, mesmo que o envio seja recusado
+            if (!m_head_encoded) {
+                codec_len = emg_codec_encode(p_packet->samples, EMG_PACKET_SIZE,
+                                             m_emg_service.max_error,
+                                             p_packet->quality_flags, &codec_buf.codec);
+                m_head_encoded = true;
+            }
+            if (v2) {
+                codec_buf.hdr          = p_buf->hdr;
+                codec_buf.hdr.encoding = EMG_ENCODING_WAVELET;
+                err = ble_emg_service_notify_packet_v2(&m_emg_service, m_emg_service.conn_handle,
+                                                       &codec_buf.hdr, sizeof(emg_packet_hdr_t) + codec_len);
+            } else {
+                err = ble_emg_service_notify_encoded(&m_emg_service, m_emg_service.conn_handle,
+                                                     &codec_buf.codec, codec_len);
+            }
+        } else if (v2) {
+            p_buf->hdr.encoding = EMG_ENCODING_RAW;
+            err = ble_emg_service_notify_packet_v2(&m_emg_service, m_emg_service.conn_handle,
+                                                   &p_buf->hdr, EMG_PACKET_V2_RAW_LEN);
+        } else {
+            err = ble_emg_service_notify_packet(&m_emg_service, m_emg_service.conn_handle, p_packet);
+        }
+
+        if (err == NRF_ERROR_BUSY || err == NRF_ERROR_RESOURCES) {
+            return;                                 // Fica na fila para a próxima tentativa
+        }
+        if (err != NRF_SUCCESS) {
+            m_packet_errors++;
+        }
+        m_last_live_seq = seq;
+        packet_release_head();
+
+        if (m_packets_sent++ % 100 == 0) {
+            NRF_LOG_INFO("BLE: sent=%d errors=%d", m_packets_sent, m_packet_errors);
+        }
+    }
+
+    // Catch-up: o backlog usa o que sobrou da fila do SoftDevice neste ciclo
+    if (!ble_emg_service_is_subscribed(&m_emg_service, EMG_SUB_BACKLOG)) {
+        return;
+    }
+    emg_backlog_record_t const * p_record;
+    while ((p_record = emg_backlog_peek()) != NULL) {
+        uint32_t err = ble_emg_service_notify_backlog(&m_emg_service, m_emg_service.conn_handle,
+                                                      (emg_stream_packet_t const *)p_record->data);
+        if (err == NRF_ERROR_BUSY || err == NRF_ERROR_RESOURCES) {
+            return;
+        }
+        emg_backlog_pop(sample_clock_ms());
+        if (emg_backlog_empty()) {
+            emg_backlog_stats_t stats;
+            emg_backlog_get_stats(&stats, sample_clock_ms());
+            NRF_LOG_INFO("Backlog drained: catch-up %d ms", stats.catch_up_ms);
+        }
+    }
+}
+
+// Sem stream (desconectado ou modo captura): devolve tudo ao pool
+static void packet_pool_reset(void) {
+    while (m_tx_queue_count > 0) {
+        packet_release_head();
+    }
+    if (m_packet_fill != NULL) {
+        nrf_balloc_free(&m_packet_pool, m_packet_fill);
+        m_packet_fill = NULL;
+    }
+}
+
+// === Eventos (app_scheduler / tarefas FreeRTOS) ===
+// Cada evento tem o seu handler; o estado que antes vivia no while(1) do main()
+// fica aqui. Blocos do ADC alternam entre dois buffers: o ADC segue enchendo um
+// enquanto o pipeline processa o outro. Na variante FreeRTOS cada handler roda
+// na tarefa da tabela: I2C só na aquisição, pipeline no DSP, store → pacotes →
+// BLE no rádio. Estado do DSP mexido pelo rádio fica sob emg_sched_lock().
+static int16_t            m_blocks[2][EMG_PIPELINE_BLOCK_LEN];
+#if EMG_CHANNEL_COUNT > 1
+static int16_t            m_frames[2][EMG_PIPELINE_BLOCK_LEN][EMG_CHANNEL_COUNT];  // Frames de cada bloco
+#endif
+static uint8_t            m_fill_buf;
+static uint16_t           m_block_fill;
+static uint8_t            m_ready_buf;
+static uint32_t           m_ready_index;            // Índice absoluto do bloco pronto
+static emg_stage_stats_t  m_stage_stats[EMG_PIPELINE_MAX_STAGES];
+static emg_sched_stats_t  m_sched_stats[EVT_COUNT];
+
+static emg_stream_packet_t m_raw_packet;
+static uint32_t            m_raw_seq;
+static uint16_t            m_raw_flags;              // Flags do pacote bruto em envio
+static bool                m_raw_flags_taken;        // Bloco fechado; reenvio após BUSY reutiliza
+static emg_capture_chunk_t m_capture_chunk;
+static emg_evoked_chunk_t  m_evoked_chunk;
+static uint8_t             m_packet_index;
+static emg_rate_evt_t      m_rate_evt;
+static bool                m_rate_tag_pending;
+static uint16_t            m_output_rate = EMG_SAMPLE_RATE_HZ;   // Taxa aceita do client
+static uint16_t            m_capture_pre_ms  = EMG_CAPTURE_DEFAULT_PRE_MS;
+static uint16_t            m_capture_post_ms = EMG_CAPTURE_DEFAULT_POST_MS;
+static volatile bool       m_adc_mode_pending;       // Troca de modo do ADC pedida pelo stream
+static volatile bool       m_adc_rest;
+static bool                m_adc_rest_active;        // Taxa em que o ADC converte agora
+static uint16_t            m_rest_phase;             // Acumulador de fase 330 SPS → grade de 1 kHz
+
+static bool stream_active(void) {
+    // Em modo captura o stream contínuo fica desligado: rádio só nos bursts
+    return ble_emg_service_is_subscribed(&m_emg_service, EMG_SUB_STREAM) && !emg_core_capture_mode();
+}
+
+// Em repouso a saída fica limitada a EMG_ADAPT_REST_RATE_HZ
+static void apply_output_rate(void) {
+    uint16_t target_rate = emg_core_full_rate() ? m_output_rate : MIN(m_output_rate, EMG_ADAPT_REST_RATE_HZ);
+    if (target_rate != emg_decimator_rate_hz()) {
+        // Troca adaptativa não reinicia o pacote: a transição é marcada nele
+        (void)emg_decimator_select(target_rate);
+    }
+}
+
+// Tudo que espera espaço na fila do SoftDevice: bursts, média evocada, stream e bruto
+static void tx_pump(void) {
+    // Burst pronto: reenviado enquanto a fila do SoftDevice estiver cheia
+    emg_sched_lock();
+    uint16_t capture_len;
+    while (emg_capture_peek_chunk(&m_capture_chunk, &capture_len)) {
+        uint32_t cap_err = ble_emg_service_notify_capture(&m_emg_service, m_emg_service.conn_handle,
+                                                          &m_capture_chunk, capture_len);
+        if (cap_err == NRF_SUCCESS) {
+            emg_capture_chunk_sent();
+        } else {
+            if (cap_err != NRF_ERROR_RESOURCES) {
+                // Sem conexão ou sem inscrição: descarta o burst e volta a gravar
+                emg_capture_abort();
+            }
+            break;
+        }
+    }
+
+    // Média pronta: mesmo esquema de chunks da captura
+    uint16_t evoked_len;
+    while (emg_evoked_peek_chunk(&m_evoked_chunk, &evoked_len)) {
+        uint32_t evk_err = ble_emg_service_notify_evoked(&m_emg_service, m_emg_service.conn_handle,
+                                                         &m_evoked_chunk, evoked_len);
+        if (evk_err == NRF_SUCCESS) {
+            emg_evoked_chunk_sent();
+        } else {
+            if (evk_err != NRF_ERROR_RESOURCES) {
+                NRF_LOG_WARNING("Evoked average dropped: 0x%x", evk_err);
+                emg_evoked_discard();
+            }
+            break;
+        }
+    }
+    emg_sched_unlock();
+
+    if (stream_active()) {
+        packet_flush();
+    }
+
+    // Stream bruto: pacote montado direto da view e consumido só quando o
+    // SoftDevice aceita — BUSY não descarta amostras
+    while (emg_store_available(EMG_STORE_VIEW_RAW) >= EMG_PACKET_SIZE) {
+        uint16_t got = 0;
+        while (got < EMG_PACKET_SIZE) {
+            emg_store_frame_t const * p_frames;
+            uint16_t n = emg_store_peek(EMG_STORE_VIEW_RAW, got, &p_frames, EMG_PACKET_SIZE - got);
+            for (uint16_t i = 0; i < n; i++) {
+                m_raw_packet.packet.samples[got + i] = p_frames[i].raw;
+            }
+            got += n;
+        }
+        // Bloco de qualidade próprio do stream bruto, fechado neste pacote
+        if (!m_raw_flags_taken) {
+            emg_sched_lock();
+            m_raw_flags = emg_quality_take_flags(EMG_QUALITY_VIEW_RAW);
+            emg_sched_unlock();
+            m_raw_flags_taken = true;
+        }
+        m_raw_packet.packet.quality_flags = m_raw_flags;
+        m_raw_packet.hdr.first_sample = emg_store_sample_index(EMG_STORE_VIEW_RAW, 0);
+        m_raw_packet.packet.quality_flags =
+            packet_header_fill(&m_raw_packet.hdr, m_raw_packet.packet.quality_flags,
+                               emg_store_sample_index(EMG_STORE_VIEW_RAW, EMG_PACKET_SIZE - 1));
+
+        uint32_t raw_err;
+        if (m_emg_service.packet_version == EMG_PACKET_VERSION_2) {
+            m_raw_packet.hdr.encoding      = EMG_ENCODING_RAW;
+            m_raw_packet.hdr.seq           = m_raw_seq;
+            m_raw_packet.hdr.rate_hz       = EMG_SAMPLE_RATE_HZ;
+            m_raw_packet.hdr.quality_flags = m_raw_packet.packet.quality_flags;
+            raw_err = ble_emg_service_notify_raw_v2(&m_emg_service, m_emg_service.conn_handle,
+                                                    &m_raw_packet.hdr, EMG_PACKET_V2_RAW_LEN);
+        } else {
+            raw_err = ble_emg_service_notify_raw(&m_emg_service, m_emg_service.conn_handle,
+                                                 &m_raw_packet.packet);
+        }
+        if (raw_err == NRF_ERROR_BUSY || raw_err == NRF_ERROR_RESOURCES) {
+            break;
+        }
+        emg_store_consume(EMG_STORE_VIEW_RAW, EMG_PACKET_SIZE);
+        m_raw_seq++;
+        m_raw_flags_taken = false;
+    }
+}
+
+// Stream filtrado: amostras decimadas copiadas para a posição final do pacote
+static void stream_drain(void) {
+    bool streaming = stream_active();
+    if (!streaming) {
+        packet_pool_reset();
+        m_packet_index = 0;
+    }
+
+    int16_t  out_sample;
+    uint32_t sample_index;
+    while (true) {
+        emg_stream_packet_t * p_buf = NULL;
+        if (streaming) {
+            p_buf = packet_fill();
+            if (p_buf == NULL) {
+                break;                              // Pool esgotado: amostras esperam no store
+            }
+        }
+        if (!emg_core_stream_pop(&out_sample, &sample_index)) {
+            break;
+        }
+        if (streaming) {
+            p_buf->packet.samples[m_packet_index] = out_sample;   // Campo packed: atribuição, sem ponteiro
+            // Timestamp e taxa do pacote vêm da primeira amostra
+            if (m_packet_index == 0) {
+                m_packet_fill->hdr.first_sample = sample_index;
+                m_packet_fill->hdr.rate_hz      = emg_decimator_rate_hz();
+            }
+            m_packet_last_index = sample_index;
+        }
+
+        // Rate-limit UART: imprime 1 em cada 100 amostras (~10 Hz) para poupar energia
+        static uint32_t uart_sample_count = 0;
+        if (uart_sample_count++ % 100 == 0) {
+            char buf[32];
+            snprintf(buf, sizeof(buf), "%d\r\n", out_sample);
+            uart_print_async(buf);
+        }
+
+        // Primeira amostra na nova taxa: marca o pacote e informa a posição
+        if (m_rate_tag_pending) {
+            m_rate_tag_pending = false;
+            m_rate_evt.rate_hz       = emg_decimator_rate_hz();
+            m_rate_evt.packet_offset = m_packet_index;
+            emg_sched_lock();
+            emg_quality_mark(EMG_QUALITY_FLAG_RATE_CHANGE);
+            emg_sched_unlock();
+            (void)ble_emg_service_notify_rate_mode(&m_emg_service, m_emg_service.conn_handle, &m_rate_evt);
+        }
+
+        if (streaming && ++m_packet_index >= EMG_PACKET_SIZE) {
+            // Flags acumuladas sobre as amostras brutas que formaram este pacote
+            emg_sched_lock();
+            m_packet_fill->packet.quality_flags = emg_quality_take_flags(EMG_QUALITY_VIEW_FILTERED);
+            emg_sched_unlock();
+            packet_commit();
+            m_packet_index = 0;
+            packet_flush();
+        }
+    }
+}
+
+// Telemetria de 1 s: custo do pipeline, store, backlog e prazos dos eventos
+static void publish_stats(void) {
+    emg_sched_lock();
+    uint8_t n_stages = emg_pipeline_take_stats(m_stage_stats, EMG_PIPELINE_MAX_STAGES);
+    emg_sched_unlock();
+    (void)ble_emg_service_update_pipeline_stats(&m_emg_service, m_stage_stats, n_stages);
+
+    // Ocupação e perdas do store: atraso do rádio deixa rastro
+    static uint32_t last_overflows = 0;
+    emg_store_stats_t store_stats;
+    emg_store_get_stats(&store_stats);
+    (void)ble_emg_service_update_store_stats(&m_emg_service, &store_stats);
+    uint32_t overflows = 0;
+    for (uint8_t v = 0; v < EMG_STORE_VIEW_COUNT; v++) {
+        overflows += store_stats.views[v].overflows;
+    }
+    if (overflows != last_overflows) {
+        NRF_LOG_WARNING("Store full: %d frames lost", overflows - last_overflows);
+        last_overflows = overflows;
+    }
+
+    emg_backlog_stats_t backlog_stats;
+    emg_backlog_get_stats(&backlog_stats, sample_clock_ms());
+    (void)ble_emg_service_update_backlog_stats(&m_emg_service, &backlog_stats);
+
+    uint8_t n_events = emg_sched_take_stats(m_sched_stats, EVT_COUNT);
+    for (uint8_t i = 0; i < n_events; i++) {
+        if (m_sched_stats[i].missed != 0 || m_sched_stats[i].dropped != 0) {
+            NRF_LOG_WARNING("Event %d: %d late (max %d us), %d dropped", i,
+                            m_sched_stats[i].missed, m_sched_stats[i].max_latency_us,
+                            m_sched_stats[i].dropped);
+        }
+    }
+    (void)ble_emg_service_update_sched_stats(&m_emg_service, m_sched_stats, n_events);
+}
+
+// Uma amostra (um frame) na grade de EMG_SAMPLE_RATE_HZ do pipeline
+static void acq_push(int16_t raw_data) {
+    trigger_sample_read();
+
+#if EMG_CHANNEL_COUNT > 1
+    memcpy(m_frames[m_fill_buf][m_block_fill], m_adc_frame, sizeof(m_adc_frame));
+#endif
+    m_blocks[m_fill_buf][m_block_fill++] = raw_data;
+    if (m_block_fill >= EMG_PIPELINE_BLOCK_LEN) {
+        m_ready_buf   = m_fill_buf;
+        m_ready_index = m_sample_count - m_block_fill;
+        m_fill_buf   ^= 1;
+        m_block_fill  = 0;
+        emg_sched_post(EVT_BLOCK_READY);
+    }
+}
+
+static void on_adc_ready(void) {
+    int16_t raw_data;
+    if (adc_read(&raw_data)) {
+        if (!m_adc_rest_active) {
+            acq_push(raw_data);
+        } else {
+            // REST: uma leitura por conversão (330 SPS), repetida 3 ou 4 vezes
+            // pelo acumulador de fase para índices, tempos e decimação do
+            // stream seguirem na grade de 1 kHz
+            m_rest_phase += EMG_SAMPLE_RATE_HZ * EMG_CHANNEL_COUNT;
+            while (m_rest_phase >= ADS112C04_REST_DATA_RATE_SPS) {
+                m_rest_phase -= ADS112C04_REST_DATA_RATE_SPS;
+                acq_push(raw_data);
+            }
+        }
+    }
+
+    // Depois da leitura: a conversão lida ainda é da taxa anterior
+    if (m_adc_mode_pending) {
+        m_adc_mode_pending = false;
+        // ADC em modo normal de baixa taxa no repouso; volta ao modo raw no onset.
+        // O DRDY acompanha a taxa nova: nenhuma conversão é lida duas vezes
+        if (ads112c04_set_rest_mode(&m_twi, m_adc_rest)) {
+            m_adc_rest_active = m_adc_rest;
+            m_rest_phase      = 0;
+        }
+    }
+}
+
+static void on_block_ready(void) {
+    emg_sched_lock();
+    (void)emg_core_process_block(m_blocks[m_ready_buf], EMG_PIPELINE_BLOCK_LEN, m_ready_index);
+#if EMG_CHANNEL_COUNT > 1
+    // FFT por canal fora da aquisição: o I2C segue no ritmo do DRDY
+    emg_core_process_frames(m_frames[m_ready_buf], EMG_PIPELINE_BLOCK_LEN);
+#endif
+    emg_sched_unlock();
+    emg_sched_post(EVT_STREAM_READY);
+}
+
+static void on_stream_ready(void) {
+    // Transição da taxa adaptativa decidida no pipeline
+    uint32_t switch_index;
+    if (emg_core_take_rate_switch(&switch_index)) {
+        bool rest = (emg_adaptive_state() == EMG_ADAPT_REST);
+        // I2C só no contexto da aquisição
+        m_adc_rest         = rest;
+        m_adc_mode_pending = true;
+        m_rate_evt.adaptive     = emg_adaptive_enabled();
+        m_rate_evt.state        = (uint8_t)emg_adaptive_state();
+        m_rate_evt.sample_index = switch_index;
+        m_rate_tag_pending = true;
+        apply_output_rate();
+        NRF_LOG_INFO("Adaptive rate: %s @ sample %d", rest ? "rest" : "full", switch_index);
+    }
+
+    // Pelo índice das amostras: eventos coalescidos não atrasam a telemetria
+    static uint32_t stats_index = 0;
+    if (m_ready_index - stats_index >= EMG_SAMPLE_RATE_HZ) {
+        stats_index = m_ready_index;
+        publish_stats();
+    }
+
+    stream_drain();
+    tx_pump();
+}
+
+static void on_tx_complete(void) {
+    tx_pump();
+    // Buffers devolvidos ao pool: amostras que esperavam no store seguem
+    stream_drain();
+}
+
+static void on_gain_change(void) {
+    static uint8_t applied_level = 0;
+    uint8_t level = m_emg_service.gain_level;
+
+    // Atualiza resistência do DS3502 (mapeamento nível → wiper no núcleo)
+    if (level != applied_level && emg_core_set_gain(level)) {
+        applied_level = level;
+        // Próxima leitura do ADC já sai com o ganho novo: índice antes da época
+        m_gain_change_index = m_sample_count;
+        m_gain_epoch++;
+    }
+}
+
+// === Gerenciador de streams ===
+// O mapa de inscrições (CCCD) decide o que roda. Sem nenhuma característica
+// inscrita o ADC fica em power-down e sem tick de amostragem; o stream filtrado
+// (empacotamento e UART) só com a característica EMG, o bruto só com a sua.
+static volatile bool m_acq_requested = false;
+static bool          m_acq_running   = false;
+
+// Perfil do link pela demanda: bruto, catch-up do backlog ou fila de envio
+// acumulando pedem vazão; stream filtrado e bursts cabem no de baixo consumo
+static ble_emg_link_profile_t link_demand(void) {
+    if (ble_emg_service_is_subscribed(&m_emg_service, EMG_SUB_RAW) || !emg_backlog_empty() ||
+        m_tx_queue_count > EMG_PACKET_POOL_SIZE / 2) {
+        return BLE_EMG_LINK_HIGH_THROUGHPUT;
+    }
+    if (stream_active() ||
+        ble_emg_service_is_subscribed(&m_emg_service, EMG_SUB_CAPTURE | EMG_SUB_EVOKED | EMG_SUB_CROSS)) {
+        return BLE_EMG_LINK_LOW_POWER;
+    }
+    return BLE_EMG_LINK_IDLE;
+}
+
+static void stream_manager_update(void) {
+    bool acq = ble_emg_service_is_subscribed(&m_emg_service, EMG_SUB_ALL);
+    if (acq != m_acq_requested) {
+        m_acq_requested = acq;
+        emg_sched_post(EVT_ACQ_CHANGE);
+    }
+    // Subida de perfil imediata na inscrição; descida pelo tick do link
+    ble_emg_link_request(link_demand());
+}
+
+// Liga/desliga a aquisição no contexto do I2C do ADC
+static void on_acq_change(void) {
+    bool run = m_acq_requested;
+    if (run == m_acq_running) {
+        return;
+    }
+    if (run) {
+        if (!ads112c04_start(&m_twi)) {
+            NRF_LOG_WARNING("ADS112C04 start failed");
+            return;
+        }
+        nrfx_gpiote_in_event_enable(DRDY_PIN, true);
+    } else {
+        nrfx_gpiote_in_event_disable(DRDY_PIN);
+        (void)ads112c04_powerdown(&m_twi);
+        m_block_fill = 0;                   // Bloco parcial não é contínuo com o próximo
+    }
+    m_acq_running = run;
+    NRF_LOG_INFO("Acquisition %s", run ? "started" : "stopped");
+}
+
+static void on_config_change(void) {
+    emg_sched_lock();
+
+    // Troca IIR/FIR pedida pelo client
+    uint8_t requested_filter = m_emg_service.filter_type;
+    if (requested_filter != emg_bandpass_type()) {
+        if (emg_bandpass_select(requested_filter)) {
+            NRF_LOG_INFO("Band-pass filter changed to %s",
+                         requested_filter == EMG_BANDPASS_FIR ? "FIR" : "IIR");
+        } else {
+            m_emg_service.filter_type = emg_bandpass_type();
+        }
+    }
+
+    // Reconfigura o Welch se o client mudou resolução/janela
+    static uint8_t psd_seg_log2 = EMG_WELCH_DEFAULT_LOG2;
+    static uint8_t psd_seconds  = EMG_WELCH_DEFAULT_SECONDS;
+    uint8_t req_seg_log2, req_seconds;
+    if (ble_emg_service_take_psd_cfg(&m_emg_service, &req_seg_log2, &req_seconds)) {
+        if (emg_welch_configure(req_seg_log2, req_seconds)) {
+            psd_seg_log2 = req_seg_log2;
+            psd_seconds  = req_seconds;
+            NRF_LOG_INFO("PSD config: %d points, %d s", 1 << psd_seg_log2, psd_seconds);
+        } else {
+            NRF_LOG_WARNING("Unsupported PSD config: 2^%d points, %d s", req_seg_log2, req_seconds);
+            (void)ble_emg_service_update_psd_cfg(&m_emg_service, psd_seg_log2, psd_seconds);
+        }
+    }
+
+    // Ativa o modelo do classificador recebido em chunks. Enquanto model_commit_len
+    // != 0 o serviço recusa escritas no staging; só libera depois da leitura.
+    uint16_t model_len = m_emg_service.model_commit_len;
+    if (model_len != 0) {
+        bool loaded = emg_classifier_commit(model_len, EMG_FEAT_COUNT);
+        m_emg_service.model_commit_len = 0;
+        if (loaded) {
+            NRF_LOG_INFO("Classifier model loaded: %d bytes", model_len);
+            emg_core_class_reset();
+        } else {
+            NRF_LOG_WARNING("Invalid classifier model: %d bytes", model_len);
+        }
+        emg_classifier_status_t clf_status;
+        emg_classifier_status(&clf_status);
+        (void)ble_emg_service_update_classifier_status(&m_emg_service, &clf_status);
+    }
+
+    // Nova sessão de estatísticas pedida pelo client
+    if (m_emg_service.stats_reset) {
+        m_emg_service.stats_reset = false;
+        emg_stats_init();
+        emg_stats_snapshot_t stats_snapshot;
+        emg_stats_snapshot(&stats_snapshot);
+        (void)ble_emg_service_update_stats(&m_emg_service, m_emg_service.conn_handle, &stats_snapshot);
+        NRF_LOG_INFO("Session stats reset");
+    }
+
+    // Janela de captura pedida pelo client
+    if (m_emg_service.capture_pre_ms != m_capture_pre_ms || m_emg_service.capture_post_ms != m_capture_post_ms) {
+        if (emg_capture_configure(m_emg_service.capture_pre_ms, m_emg_service.capture_post_ms)) {
+            m_capture_pre_ms  = m_emg_service.capture_pre_ms;
+            m_capture_post_ms = m_emg_service.capture_post_ms;
+            NRF_LOG_INFO("Capture window: %d ms pre, %d ms post", m_capture_pre_ms, m_capture_post_ms);
+        } else {
+            m_emg_service.capture_pre_ms  = m_capture_pre_ms;
+            m_emg_service.capture_post_ms = m_capture_post_ms;
+            (void)ble_emg_service_update_capture_cfg(&m_emg_service);
+        }
+    }
+
+    bool capture_mode = (m_emg_service.capture_mode == EMG_CAPTURE_MODE_TRIGGER);
+    emg_core_set_capture(capture_mode, m_emg_service.capture_triggers);
+
+    // Views do store: filtrado só com o stream EMG inscrito (UART junto), bruto idem
+    emg_store_set_active(EMG_STORE_VIEW_FILTERED,
+                         !capture_mode && ble_emg_service_is_subscribed(&m_emg_service, EMG_SUB_STREAM));
+    emg_store_set_active(EMG_STORE_VIEW_RAW, ble_emg_service_is_subscribed(&m_emg_service, EMG_SUB_RAW));
+    static bool last_capture_mode = false;
+    if (capture_mode != last_capture_mode) {
+        // Troca de modo: histórico antigo não é contínuo com o novo; descarta burst pendente
+        last_capture_mode = capture_mode;
+        (void)emg_capture_configure(m_capture_pre_ms, m_capture_post_ms);
+        NRF_LOG_INFO("Capture mode %s", capture_mode ? "on" : "off");
+    }
+    if (m_emg_service.capture_client_trigger) {
+        m_emg_service.capture_client_trigger = false;
+        emg_core_capture_trigger(EMG_CAPTURE_SRC_CLIENT);
+    }
+
+    // Média evocada pedida pelo client (o TIMER de timestamp acompanha)
+    static uint16_t evoked_trials    = 0;
+    static uint16_t evoked_window_ms = EMG_EVOKED_DEFAULT_WINDOW_MS;
+    if (m_emg_service.evoked_trials != evoked_trials || m_emg_service.evoked_window_ms != evoked_window_ms) {
+        if (emg_evoked_configure(m_emg_service.evoked_trials, m_emg_service.evoked_window_ms)) {
+            evoked_trials    = m_emg_service.evoked_trials;
+            evoked_window_ms = m_emg_service.evoked_window_ms;
+            NRF_LOG_INFO("Evoked average: %d trials, %d ms", evoked_trials, evoked_window_ms);
+        } else {
+            m_emg_service.evoked_trials    = evoked_trials;
+            m_emg_service.evoked_window_ms = evoked_window_ms;
+            (void)ble_emg_service_update_evoked_cfg(&m_emg_service);
+        }
+        trigger_timer_enable(emg_evoked_enabled());
+    }
+
+    // Taxa adaptativa: liga/desliga pelo client; transição decidida no pipeline
+    if (m_emg_service.adaptive_rate != emg_adaptive_enabled()) {
+        emg_adaptive_enable(m_emg_service.adaptive_rate);
+        NRF_LOG_INFO("Adaptive rate %s", m_emg_service.adaptive_rate ? "on" : "off");
+    }
+    emg_sched_unlock();
+
+    // Aplica a taxa de saída pedida pelo client (decimação antes do empacotamento)
+    uint16_t requested_rate = m_emg_service.output_rate_hz;
+    if (requested_rate != m_output_rate) {
+        if (emg_decimator_select(requested_rate)) {
+            m_output_rate = requested_rate;
+            m_packet_index = 0;
+            NRF_LOG_INFO("Output rate changed to %d Hz", requested_rate);
+        } else {
+            NRF_LOG_WARNING("Unsupported output rate: %d Hz", requested_rate);
+            m_emg_service.output_rate_hz = m_output_rate;
+            (void)ble_emg_service_update_rate(&m_emg_service);
+        }
+    }
+    apply_output_rate();
+
+    // Perfil do link fixado pelo client (medição) ou de volta ao automático
+    static uint8_t link_profile = BLE_EMG_LINK_AUTO;
+    if (m_conn_handle == BLE_CONN_HANDLE_INVALID) {
+        // O módulo do link volta ao automático na desconexão
+        link_profile = BLE_EMG_LINK_AUTO;
+        m_emg_service.link_profile = BLE_EMG_LINK_AUTO;
+    } else if (m_emg_service.link_profile != link_profile) {
+        if (ble_emg_link_force(m_emg_service.link_profile)) {
+            link_profile = m_emg_service.link_profile;
+        } else {
+            NRF_LOG_WARNING("Invalid link profile: %d", m_emg_service.link_profile);
+            m_emg_service.link_profile = link_profile;
+        }
+    }
+    stream_manager_update();
+
+    // Conexão ou modo mudou: libera/retoma o stream e envia o que já estiver pronto
+    stream_drain();
+    tx_pump();
+}
+
+// Trigger externo: timestamp já capturado em hardware, aqui só é resolvido
+static void on_trigger(void) {
+    emg_trigger_evt_t trigger_evt;
+    trigger_resolve(&trigger_evt);
+    emg_sched_lock();
+    trigger_evt.trial = emg_evoked_trigger(trigger_evt.sample_index);
+    emg_quality_mark(EMG_QUALITY_FLAG_TRIGGER);
+    emg_core_capture_trigger(EMG_CAPTURE_SRC_GPIO);
+    emg_sched_unlock();
+    (void)ble_emg_service_notify_trigger(&m_emg_service, m_emg_service.conn_handle, &trigger_evt);
+}
+
+// Perfil pela demanda, tempo e bytes por perfil, estado legível do link
+static void on_link_tick(void) {
+    ble_emg_link_request(link_demand());
+    ble_emg_link_tick(m_emg_service.tx_bytes);
+
+    ble_emg_link_status_t link_status;
+    ble_emg_link_status(&link_status);
+    (void)ble_emg_service_update_link_status(&m_emg_service, &link_status);
+}
+
+// Prazo = postagem → fim do handler. Ganho é I2C: fica com a aquisição
+static const emg_sched_event_t m_events[EVT_COUNT] = {
+    [EVT_ADC_READY]     = { "adc",     on_adc_ready,     1000,  false, EMG_SCHED_TASK_ACQ   },  // Antes da próxima conversão
+    [EVT_BLOCK_READY]   = { "block",   on_block_ready,   10000, false, EMG_SCHED_TASK_DSP   },  // Antes do próximo bloco
+    [EVT_STREAM_READY]  = { "stream",  on_stream_ready,  20000, true,  EMG_SCHED_TASK_RADIO },  // Store absorve o atraso
+    [EVT_TX_COMPLETE]   = { "tx",      on_tx_complete,   7500,  true,  EMG_SCHED_TASK_RADIO },  // Dentro do connection event
+    [EVT_GAIN_CHANGE]   = { "gain",    on_gain_change,   50000, true,  EMG_SCHED_TASK_ACQ   },
+    [EVT_CONFIG_CHANGE] = { "config",  on_config_change, 50000, true,  EMG_SCHED_TASK_RADIO },
+    [EVT_TRIGGER]       = { "trigger", on_trigger,       20000, true,  EMG_SCHED_TASK_RADIO },  // Dentro do histórico da média evocada
+    [EVT_ACQ_CHANGE]    = { "acq",     on_acq_change,    50000, true,  EMG_SCHED_TASK_ACQ   },  // I2C do ADC
+    [EVT_LINK_TICK]     = { "link",    on_link_tick,     50000, true,  EMG_SCHED_TASK_RADIO },
+};
+
 // === Main ===
 int main(void) {
     // Initialize.
@@ -659,6 +1678,7 @@ int main(void) {
     NRF_LOG_INFO("Initializing hardware peripherals...");
     led_init();
     gpio_init();
+    trigger_init();
     uart_init();
     uart_print_async("\r\nSystem Booting...\r\n");
 
@@ -686,6 +1706,8 @@ int main(void) {
     }
     uart_print_async("ADS112C04 configured.\r\n");
     NRF_LOG_INFO("ADS112C04 in raw mode - ready for sampling");
+    // Conversões param até a primeira inscrição (gerenciador de streams)
+    (void)ads112c04_powerdown(&m_twi);
 
     // Configura resistência do DS3502
     if (ds3502_set_resistance(&m_twi, RESISTANCE_SETTING)) {
@@ -695,79 +1717,45 @@ int main(void) {
         uart_print_async("Failed to set DS3502 resistance.\r\n");
         NRF_LOG_WARNING("DS3502 initialization failed");
     }
-    int16_t raw_data = 0;
-    int16_t out_sample = 0;
+    APP_ERROR_CHECK_BOOL(emg_core_init(&m_core_platform));
+    APP_ERROR_CHECK(nrf_balloc_init(&m_packet_pool));
+    emg_backlog_init();
+    NRF_LOG_INFO("DSP pipeline: %d stages", emg_pipeline_stage_count());
+#ifdef DEBUG
+    emg_fir_benchmark();
+#endif
 
-    // Buffer de pacotes para transmissão BLE otimizada
-    static int16_t ble_packet_buffer[EMG_PACKET_SIZE];
-    uint8_t packet_index = 0;
+    APP_ERROR_CHECK_BOOL(emg_sched_init(m_events, ARRAY_SIZE(m_events)));
 
     // Inicia LED blink via app_timer (usa LFCLK, sem manter HFCLK ativo)
     ret_code_t err_code_led = app_timer_start(m_led_timer_id, APP_TIMER_TICKS(1000), NULL);
     APP_ERROR_CHECK(err_code_led);
+    APP_ERROR_CHECK(app_timer_start(m_link_timer_id, APP_TIMER_TICKS(1000), NULL));
+
+    // Estado inicial de ganho/configuração aplicado pelos próprios handlers
+    emg_sched_post(EVT_GAIN_CHANGE);
+    emg_sched_post(EVT_CONFIG_CHANGE);
+    drdy_init();
 
     NRF_LOG_INFO("========================================");
     NRF_LOG_INFO("System ready - low-power mode");
-    NRF_LOG_INFO("Sampling rate: 1000 SPS | Packet: %d samples | BLE interval: 75-100ms", EMG_PACKET_SIZE);
+    NRF_LOG_INFO("Sampling rate: 1000 SPS | Packet: %d samples | Link profile: %s", EMG_PACKET_SIZE,
+                 ble_emg_link_cfg(BLE_EMG_LINK_INITIAL)->p_name);
     NRF_LOG_INFO("========================================");
 
+#if EMG_RTOS
+    // Eventos da SoftDevice numa tarefa própria; tickless idle dorme entre as bordas de DRDY
+    nrf_sdh_freertos_init(NULL, NULL);
+    vTaskStartScheduler();
+    APP_ERROR_HANDLER(NRF_ERROR_FORBIDDEN);     // Só retorna sem heap para a tarefa idle
+#else
     while (1)
     {
-        // Atualiza resistência do DS3502 se gain_level mudou
-        static uint8_t last_gain_level = 0xFF;
-        if (gain_level != last_gain_level && gain_level >= 1 && gain_level <= 10)
-        {
-            uint8_t wiper_value = (gain_level - 1) * 0x0D;
-            if (ds3502_set_resistance(&m_twi, wiper_value)) {
-                last_gain_level = gain_level;
-                NRF_LOG_INFO("Gain level changed to %d (wiper: 0x%02X)", gain_level, wiper_value);
-            }
-        }
-
-        if (ads112c04_read_data(&m_twi, &raw_data))
-        {
-            float filtered = butterworth_filter((float)raw_data);
-            fifo_push((int16_t)(filtered));
-        }
-
-        if (fifo_pop(&out_sample)) {
-            // Rate-limit UART: imprime 1 em cada 100 amostras (~10 Hz) para poupar energia
-            static uint32_t uart_sample_count = 0;
-            if (uart_sample_count++ % 100 == 0) {
-                char buf[32];
-                snprintf(buf, sizeof(buf), "%d\r\n", out_sample);
-                uart_print_async(buf);
-            }
-
-            if (m_conn_handle != BLE_CONN_HANDLE_INVALID) {
-                ble_packet_buffer[packet_index++] = out_sample;
-
-                if (packet_index >= EMG_PACKET_SIZE) {
-                    static uint32_t packet_count = 0;
-                    static uint32_t packet_errors = 0;
-
-                    uint32_t ble_err = ble_emg_service_notify_packet(&m_emg_service,
-                                                                      m_emg_service.conn_handle,
-                                                                      ble_packet_buffer,
-                                                                      EMG_PACKET_SIZE);
-
-                    if (ble_err != NRF_SUCCESS && ble_err != NRF_ERROR_BUSY) {
-                        packet_errors++;
-                    }
-                    if (packet_count++ % 100 == 0) {
-                        NRF_LOG_INFO("BLE: sent=%d errors=%d", packet_count, packet_errors);
-                    }
-
-                    if (ble_err == NRF_SUCCESS || ble_err == NRF_ERROR_BUSY) {
-                        packet_index = 0;
-                    }
-                }
-            } else {
-                packet_index = 0;
-            }
-        }
+        // Só acorda com trabalho: cada evento roda o seu handler
+        emg_sched_execute();
 
         // Dorme até próximo evento (BLE, timer, I2C) — principal ganho de energia
         idle_state_handle();
     }
+#endif
 }
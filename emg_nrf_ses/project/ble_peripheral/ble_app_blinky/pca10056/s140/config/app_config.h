@@ -0,0 +1,10 @@
+#ifndef APP_CONFIG_H
+#define APP_CONFIG_H
+
+// Ajustes do sdk_config.h para a variante FreeRTOS (USE_APP_CONFIG, definido só
+// no projeto ble_app_blinky_freertos_pca10056_s140.emProject).
+
+// Eventos da SoftDevice buscados pela tarefa do nrf_sdh_freertos
+#define NRF_SDH_DISPATCH_MODEL 2    // NRF_SDH_DISPATCH_MODEL_POLLING
+
+#endif // APP_CONFIG_H